@@ -0,0 +1,26 @@
+# every LemLib text path in static/ is also converted into a binary path asset (static/*.kpath), built by the
+# host tool in tools/pathgen.cpp. Set HOSTCXX if g++ is not the host compiler
+HOSTCXX?=g++
+PATHGEN=$(BINDIR)/pathgen
+
+PATH_TEXT_FILES=$(wildcard static/*.txt)
+PATH_BINARY_FILES=$(PATH_TEXT_FILES:.txt=.kpath)
+PATH_ASSET_OBJ=$(addprefix $(BINDIR)/, $(addsuffix .o, $(PATH_BINARY_FILES)) )
+
+# .kpath files left over from an earlier build are already picked up by hot-cold-asset.mk
+NEW_PATH_ASSET_OBJ:=$(filter-out $(ASSET_OBJ),$(PATH_ASSET_OBJ))
+ASSET_FILES:=$(sort $(ASSET_FILES) $(PATH_BINARY_FILES))
+
+$(PATHGEN): tools/pathgen.cpp $(INCDIR)/kachow/path.hpp
+	$(VV)mkdir -p $(BINDIR)
+	@echo "HOSTCXX $@"
+	$(VV)$(HOSTCXX) -std=c++20 -O2 -I$(INCDIR) tools/pathgen.cpp -o $@
+
+static/%.kpath: static/%.txt $(PATHGEN)
+	@echo "PATHGEN $@"
+	$(VV)$(PATHGEN) $< $@
+
+$(NEW_PATH_ASSET_OBJ): $(BINDIR)/%.o: %
+	$(VV)mkdir -p $(BINDIR)/static
+	@echo "ASSET $@"
+	$(VV)$(OBJCOPY) -I binary -O elf32-littlearm -B arm $^ $@
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "kachow/config.hpp"
+#include "kachow/relayTuner.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Parameters for autotune
+ */
+struct AutotuneSettings {
+        /** output while the relay is on, in motor units (-127 to 127). 40 by default */
+        float relay = 40;
+        /** how far past the target the mechanism has to go to switch the relay, in measurement units. 1 by default */
+        float hysteresis = 1;
+        /** how many oscillations to measure. 5 by default */
+        int cycles = 5;
+        /** how many oscillations to ignore first, while it settles. 2 by default */
+        int settleCycles = 2;
+        /** give up after this long, in ms. 15000 by default */
+        int timeout = 15000;
+};
+
+/**
+ * @brief Run a relay autotune on any mechanism
+ *
+ * Blocks until the test finishes or times out, updating every 10ms, and stops the mechanism at the end. The mechanism
+ * oscillates around the target by a few degrees or inches, so make sure it has room to move.
+ *
+ * @param measure returns the current position, e.g. arm angle in degrees
+ * @param actuate applies an output from -127 to 127. A positive output must increase the position
+ * @param target position to oscillate around
+ * @param settings struct to simulate named parameters
+ * @return RelayResult check valid before using it
+ *
+ * @b Example
+ * @code {.cpp}
+ * // tune an arm position controller around 60 degrees
+ * kachow::RelayResult result = kachow::autotune([] { return arm.get_position(); },
+ *                                               [](float output) { arm.move(output); }, 60, {.relay = 30});
+ * kachow::Gains gains = kachow::relayGains(result, kachow::TuningRule::NO_OVERSHOOT, 0.01);
+ * @endcode
+ */
+RelayResult autotune(std::function<float()> measure, std::function<void(float)> actuate, float target,
+                     AutotuneSettings settings = {});
+
+/**
+ * @brief Store gains in a config as <prefix>.kP, <prefix>.kI and <prefix>.kD
+ */
+void saveGains(Config& config, const std::string& prefix, const Gains& gains);
+
+/**
+ * @brief Read gains stored by saveGains
+ *
+ * @return true if all three were set, in which case gains is filled in
+ */
+bool loadGains(const Config& config, const std::string& prefix, Gains& gains);
+} // namespace kachow
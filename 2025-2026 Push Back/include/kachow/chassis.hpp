@@ -0,0 +1,453 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/autotune.hpp"
+#include "kachow/gainSchedule.hpp"
+#include "kachow/geometryCalibration.hpp"
+#include "kachow/path.hpp"
+#include "kachow/splinePath.hpp"
+#include "kachow/stepResponse.hpp"
+#include "kachow/trajectory.hpp"
+
+namespace kachow {
+
+/**
+ * @brief what kind of target a ChainTarget is
+ */
+enum class ChainTargetType {
+    POINT, /** drive to a point, like moveToPoint */
+    POSE, /** drive to a point and arrive at a heading, like moveToPose */
+    HEADING /** turn in place to a heading, like turnToHeading */
+};
+
+/**
+ * @brief one target in a motion chain
+ *
+ * Use the factory functions rather than filling this in by hand. Headings are in degrees, the same as everywhere else
+ * in LemLib.
+ */
+struct ChainTarget {
+        ChainTargetType type;
+        float x = 0;
+        float y = 0;
+        float theta = 0;
+        /** whether the robot should drive forwards or backwards to this target. Ignored by heading targets */
+        bool forwards = true;
+        /** the maximum speed while heading for this target. Value between 0-127 */
+        float maxSpeed = 127;
+
+        static ChainTarget point(float x, float y, bool forwards = true, float maxSpeed = 127);
+        static ChainTarget pose(float x, float y, float theta, bool forwards = true, float maxSpeed = 127);
+        static ChainTarget heading(float theta, float maxSpeed = 127);
+};
+
+/**
+ * @brief Parameters for Chassis::chain
+ */
+struct ChainParams {
+        /** how far before a point or pose the robot starts steering towards the next one, in inches. 8 by default */
+        float blendRadius = 8;
+        /** how close to a heading target the robot has to turn before moving on, in degrees. 10 by default */
+        float blendAngle = 10;
+        /** carrot point multiplier for pose targets, the same as MoveToPoseParams::lead. 0.6 by default */
+        float lead = 0.6;
+};
+
+/**
+ * @brief a nudge to the pose made with Chassis::correctPose
+ */
+struct PoseCorrection {
+        /** the pose after the correction, in inches and degrees */
+        lemlib::Pose pose;
+        /** how far it was moved along x, in inches */
+        float x;
+        /** how far it was moved along y, in inches */
+        float y;
+        /** standard deviation of the corrected position, in inches. Negative if it only took back an odometry error */
+        float error;
+};
+
+/**
+ * @brief lemlib::Chassis with our own motion algorithms added on top
+ *
+ * All of LemLib's motions are still available and share the same motion queue, so our motions can be mixed freely
+ * with moveToPoint, turnToHeading and the rest
+ *
+ * With setLatency, our motions and moveToPoint steer by where the robot will be when their command takes effect
+ * rather than where it was last measured. Only the steering uses the prediction: when to settle, exit, advance to the
+ * next target or finish a path is decided from the measured pose. moveToPose and the other LemLib motions are not
+ * compensated.
+ */
+class Chassis : public lemlib::Chassis {
+    public:
+        using lemlib::Chassis::Chassis;
+        using lemlib::Chassis::follow;
+
+        /**
+         * @brief Follow a binary path using pure pursuit
+         *
+         * Same behaviour as the text path version of follow, but the path is read straight out of the asset, so
+         * starting it costs nothing
+         *
+         * @param path the path to follow
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move faster but
+         * will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * ASSET(example_kpath);
+         *
+         * void autonomous() {
+         *     chassis.setPose(0, 0, 0);
+         *     chassis.follow(kachow::PathView(example_kpath), 15, 4000);
+         * }
+         * @endcode
+         */
+        void follow(PathView path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Follow a spline path using pure pursuit
+         *
+         * The closest point and lookahead point are worked out on the spline every iteration instead of being picked
+         * from a list of points
+         *
+         * @param path the path to follow
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move faster but
+         * will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * ASSET(rushMiddle_kspl);
+         *
+         * void autonomous() {
+         *     chassis.setPose(0, 0, 0);
+         *     chassis.follow(kachow::SplinePath(rushMiddle_kspl), 15, 4000);
+         * }
+         * @endcode
+         */
+        void follow(SplinePath path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Drive through a list of targets as one motion
+         *
+         * Stringing moveToPoint calls together with minSpeed and earlyExitRange jerks at every handoff, because each
+         * motion resets the PIDs and starts again from its own output. A chain runs every target in one loop instead:
+         * - the PIDs are reset once, and the speed is slew limited from whatever it was at the end of the last target
+         * - the lateral error is the distance left to the next place the robot has to stop (a heading target, a change
+         * of direction, or the end), so the robot does not slow down for targets it drives through
+         * - within blendRadius of a point or pose, the steering moves smoothly on to the next one
+         * - only the last target waits for the exit conditions, everything else is passed straight through
+         *
+         * @param targets targets in the order they should be reached
+         * @param timeout the maximum time the whole chain can take
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // drive through (48, 48) without stopping, turn, then back into the goal
+         * chassis.chain({kachow::ChainTarget::point(60, 36),
+         *                kachow::ChainTarget::point(48, 48),
+         *                kachow::ChainTarget::heading(-135),
+         *                kachow::ChainTarget::point(61.5, 58.5, false)},
+         *               4000);
+         * @endcode
+         */
+        void chain(std::vector<ChainTarget> targets, int timeout, ChainParams params = {}, bool async = true);
+        /**
+         * @brief Follow a trajectory on its schedule using RAMSETE
+         *
+         * Unlike follow, which goes as fast as the path allows from wherever the robot is, this tries to be at each
+         * point of the trajectory at the time the trajectory says, so mechanism actions can be timed against it. The
+         * motion ends once the trajectory has ended and the robot is within TRAJECTORY_END_TOLERANCE of its end and
+         * slower than TRAJECTORY_END_SPEED, or TRAJECTORY_SETTLE_TIME after the trajectory ends, or at the timeout if
+         * that comes first.
+         *
+         * The drive takes a while to reach the speeds it is sent, so with setTimeConstant the speeds are read that far
+         * ahead of where the robot should be, otherwise it runs behind the whole way and is still catching up at the
+         * end.
+         *
+         * @param trajectory the trajectory to follow, starting from the robot's current position
+         * @param timeout the maximum time the robot can spend moving
+         * @param controller the tracking controller. Default gains by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * ASSET(rushMiddle_kspl);
+         *
+         * void autonomous() {
+         *     chassis.setPose(0, 0, 0);
+         *     // 60in/s leaves headroom below the 76.6in/s top speed
+         *     kachow::Trajectory trajectory = kachow::Trajectory::fromPath(kachow::SplinePath(rushMiddle_kspl), 60);
+         *     chassis.followTrajectory(trajectory, 4000);
+         *     // the intake starts exactly 1.2s into the trajectory
+         *     pros::delay(1200);
+         *     intakeHold();
+         * }
+         * @endcode
+         */
+        void followTrajectory(Trajectory trajectory, int timeout, Ramsete controller = {}, bool async = true);
+        /**
+         * @brief Turn to a heading, with gain scheduling if an angular schedule has been set
+         *
+         * Without a schedule this is lemlib::Chassis::turnToHeading. With one, the angular gains are looked up from
+         * the schedule every iteration using the remaining error and the current turning speed. Exit conditions,
+         * minSpeed and earlyExitRange work like LemLib's. A forced direction is followed until the robot first crosses
+         * the target, then the robot settles the short way like LemLib does. Unlike LemLib, passing the heading
+         * opposite the target on the way round does not count as crossing it.
+         *
+         * @param theta heading location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis towards the target point
+         *
+         * Same as lemlib::Chassis::moveToPoint, which it runs unless latency compensation is on. With it on, the
+         * robot steers by getControlPose, but settling, the exit conditions and the motion chaining side check still
+         * go by the measured pose, so it stops where it really is rather than where it is predicted to be
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis towards a target pose
+         *
+         * lemlib::Chassis::moveToPose, with the timeout stretched when the drive has lost torque
+         *
+         * @param x x location
+         * @param y y location
+         * @param theta target heading in degrees
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params = {},
+                        bool async = true);
+        /**
+         * @brief Use a gain schedule for turnToHeading instead of the angular controller's fixed gains
+         *
+         * The other angular settings (windup range, exit ranges, slew) still come from the angular controller.
+         *
+         * @param schedule the schedule to use, which must outlive the chassis. nullptr goes back to LemLib's turns
+         *
+         * @b Example
+         * @code {.cpp}
+         * kachow::GainSchedule angularSchedule({10, 45, 180}, {0, 300}, {...});
+         *
+         * void initialize() {
+         *     chassis.setAngularSchedule(&angularSchedule);
+         * }
+         * @endcode
+         */
+        void setAngularSchedule(const GainSchedule* schedule);
+        /**
+         * @brief Log how every scheduled turn went, grouped by the schedule's error bands
+         *
+         * After each turn the settle time, overshoot, final error and peak turning speed are logged to the info sink,
+         * along with the running average for the turn's band, so gains can be tuned one band at a time.
+         */
+        void setTuningMode(bool enabled);
+        /**
+         * @brief results of every scheduled turn since the schedule was set
+         */
+        const TuningLog& getTuningLog() const;
+        /**
+         * @brief Relay autotune the lateral controller by rocking the robot back and forth where it stands
+         *
+         * Needs a few inches of clear space in front and behind. Takes a few seconds and does not change any gains;
+         * pass the result to relayGains and then setLateralGains.
+         *
+         * @param settings struct to simulate named parameters. Hysteresis is in inches
+         */
+        RelayResult autotuneLateral(AutotuneSettings settings = {.hysteresis = 0.25});
+        /**
+         * @brief Relay autotune the angular controller by wiggling the robot's heading where it stands
+         *
+         * @param settings struct to simulate named parameters. Hysteresis is in degrees
+         */
+        RelayResult autotuneAngular(AutotuneSettings settings = {.hysteresis = 1});
+        /**
+         * @brief Replace the lateral PID gains used by every lateral motion
+         */
+        void setLateralGains(const Gains& gains);
+        /**
+         * @brief Replace the angular PID gains used by turns and steering. Scheduled turns still use the schedule
+         */
+        void setAngularGains(const Gains& gains);
+        /**
+         * @brief Set the pose of the chassis, and tell whoever is listening with onPoseReset
+         *
+         * Same as lemlib::Chassis::setPose
+         */
+        void setPose(float x, float y, float theta, bool radians = false);
+        void setPose(lemlib::Pose pose, bool radians = false);
+        /**
+         * @brief Run a callback whenever setPose is called on this chassis, with the new pose in inches and degrees
+         *
+         * Used by anything keeping its own pose estimate, so it can start again from the same place
+         */
+        void onPoseReset(std::function<void(lemlib::Pose)> callback);
+        /**
+         * @brief Move the pose by a small correction while odometry runs, e.g. from the field walls or wheel slip
+         *
+         * The pose is read and written under a lock, so corrections from different tasks never undo each other, and
+         * this does not count as a reset. Every correction to the pose should come through here. LemLib's odometry
+         * task still writes the pose without the lock, so very rarely one 10ms odometry step can be lost.
+         *
+         * @param x inches to move along x
+         * @param y inches to move along y
+         * @param error standard deviation of the corrected position, in inches, if it is an absolute fix like a wall
+         * reading. Negative if it only takes back an odometry error. -1 by default
+         */
+        void correctPose(float x, float y, float error = -1);
+        /**
+         * @brief Run a callback after every correctPose, from the task that made the correction
+         */
+        void onPoseCorrection(std::function<void(const PoseCorrection&)> callback);
+        /**
+         * @brief Limit how fast every lateral motion may speed up, on top of the lateral controller's slew
+         *
+         * Takes effect straight away, including in the middle of a motion. Used to stop spinning the drive wheels
+         * once they have lost grip.
+         *
+         * @param slew largest increase in lateral output per 10ms, out of 127. 0 removes the cap
+         */
+        void setAccelerationCap(float slew);
+        /**
+         * @brief Limit how fast every lateral motion may speed up while the drive motors are running hot
+         *
+         * Works like setAccelerationCap, but is kept apart from it so a TractionMonitor lifting its cap doesn't lift
+         * this one too. The tighter of the two wins. Used by ThermalGuard.
+         *
+         * @param slew largest increase in lateral output per 10ms, out of 127. 0 removes the cap
+         */
+        void setThermalCap(float slew);
+        /**
+         * @brief Tell the chassis how much of its torque the drive has left, e.g. after losing a motor
+         *
+         * The lateral controller's slew is scaled down to match. If it has none, a drive short of torque still gets
+         * one, scaled from how fast a full drive gets up to speed. The timeouts of moveToPoint, moveToPose,
+         * turnToHeading and our own motions are stretched by the same factor, since the robot now takes longer to
+         * get anywhere. Used by DriveFailover.
+         *
+         * @param capacity share of full torque, from 0.25 to 1. Anything lower counts as 0.25, since motions that
+         * slow would never finish anyway
+         */
+        void setDriveCapacity(float capacity);
+        /**
+         * @brief The drivetrain as the chassis is using it, including any geometry set with setDriveGeometry
+         */
+        const lemlib::Drivetrain& getDrivetrain() const;
+        /**
+         * @brief Replace the drivetrain's track width and wheel diameter, e.g. with calibrated values
+         *
+         * LemLib builds its odometry from these in calibrate(), so call this before that.
+         */
+        void setDriveGeometry(float trackWidth, float wheelDiameter);
+        /**
+         * @brief Spin in place and measure how far every odometry wheel turned, for GeometrySolver
+         *
+         * Spin slowly, so the drive wheels do not slip; the spin is stopped once the IMU has turned far enough, and
+         * measured after the robot has come to rest.
+         *
+         * @param turns how many full turns, clockwise positive
+         * @param speed motor power, out of 127. 40 by default
+         * @param timeout give up after this long, in ms. 15000 by default
+         */
+        SpinMeasurement measureSpin(float turns, float speed = 40, int timeout = 15000);
+        /**
+         * @brief Drive straight forwards until the robot stops against a wall, and measure how far the wheels turned
+         *
+         * Start square to the wall, with the gap measured with a tape, and pass the gap to GeometrySolver::addStraight.
+         * Drive slowly, so the wheels stall instead of spinning against the wall.
+         *
+         * @param speed motor power, out of 127. Negative drives backwards. 30 by default
+         * @param timeout give up after this long, in ms. 8000 by default
+         */
+        StraightMeasurement measureWallRun(float speed = 30, int timeout = 8000);
+        /**
+         * @brief Steer every compensated motion by where the robot will be this long from now
+         *
+         * A motor command takes a few tens of ms to change what odometry measures, so at speed the controllers are
+         * always correcting an error that is already out of date, which is what makes high gains oscillate. The pose
+         * is predicted forwards by the measured velocity over the latency. Measure it with measureLatency.
+         *
+         * @param latency ms from a command being sent to odometry seeing it. 0, the default, turns compensation off
+         */
+        void setLatency(float latency);
+        /** ms, 0 when compensation is off */
+        float getLatency() const;
+        /**
+         * @brief How long the drive takes to get most of the way to a new speed, which followTrajectory leads its
+         * speeds by
+         *
+         * @param timeConstant ms for the drive wheels to get 63% of the way to a new speed, the time constant
+         * measureLatency fits. 0, the default, leads by nothing
+         */
+        void setTimeConstant(float timeConstant);
+        /** ms */
+        float getTimeConstant() const;
+        /**
+         * @brief The pose compensated motions steer by: the current pose predicted forwards by the latency
+         *
+         * Same arguments as getPose, which it matches while compensation is off
+         */
+        lemlib::Pose getControlPose(bool radians = false, bool standardPos = false);
+        /**
+         * @brief Measure the drivetrain's latency by stepping the drive motors and timing how long odometry takes to
+         * see it
+         *
+         * The robot drives forwards and then backwards about a foot per trial, so it needs that much room. Pass the
+         * dead time, in ms, to setLatency and the time constant to setTimeConstant.
+         *
+         * @param power motor power to step to, out of 127. 60 by default
+         * @param trials how many steps to average, alternating forwards and backwards. 4 by default
+         * @return StepResponse of the drive wheel velocity, in in/s
+         */
+        StepResponse measureLatency(float power = 60, int trials = 4);
+    private:
+        template <typename Pursuit> void followPursuit(Pursuit& pursuit, int timeout, bool forwards);
+
+        const GainSchedule* angularSchedule = nullptr;
+        bool tuningMode = false;
+        TuningLog tuningLog {0};
+        std::vector<std::function<void(lemlib::Pose)>> poseResetCallbacks;
+        std::vector<std::function<void(const PoseCorrection&)>> poseCorrectionCallbacks;
+        // held while the pose is set or corrected
+        pros::Mutex poseMutex;
+        // sets lateralSettings.slew from the lateral controller's own slew, the caps and the capacity. Call with
+        // slewMutex held
+        void applySlew();
+        // a motion timeout, made longer if the drive has lost torque
+        int stretchTimeout(int timeout) const;
+
+        // the lateral controller's own slew, while lateralSettings.slew is something else
+        float lateralSlew = 0;
+        bool slewReplaced = false;
+        float accelerationCap = 0;
+        float thermalCap = 0;
+        // read by stretchTimeout from the motion tasks without the lock
+        std::atomic<float> driveCapacity = 1;
+        // held while the slew, caps and capacity change. They are set from several tasks
+        pros::Mutex slewMutex;
+        // seconds
+        float latency = 0;
+        float timeConstant = 0;
+};
+} // namespace kachow
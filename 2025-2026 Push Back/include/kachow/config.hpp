@@ -0,0 +1,70 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace kachow {
+
+/**
+ * @brief Flat key=value settings file, used for everything the robot keeps on the SD card
+ *
+ * One setting per line, `key=value`. Blank lines and lines starting with # are ignored, and keys are kept in sorted
+ * order when saved so files diff cleanly. Paths on the brain start with /usd/
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::Config config;
+ * config.load("/usd/kachow.cfg"); // missing file leaves the config empty
+ * int driver = config.getInt("driver", 0);
+ * config.set("driver", 2);
+ * config.save("/usd/kachow.cfg");
+ * @endcode
+ */
+class Config {
+    public:
+        /**
+         * @brief Read settings from a file, replacing any with the same key
+         *
+         * @return true the file was read
+         * @return false the file could not be opened, e.g. no SD card
+         */
+        bool load(const std::string& path);
+        /**
+         * @brief Write all settings to a file, replacing its contents
+         *
+         * @return true the file was written
+         * @return false the file could not be opened
+         */
+        bool save(const std::string& path) const;
+        /**
+         * @brief whether a key is set
+         */
+        bool has(const std::string& key) const;
+        /**
+         * @brief Get a setting as a string, or a fallback if it is not set
+         */
+        std::string getString(const std::string& key, const std::string& fallback = "") const;
+        /**
+         * @brief Get a setting as a float, or a fallback if it is not set or not a number
+         */
+        float getFloat(const std::string& key, float fallback = 0) const;
+        /**
+         * @brief Get a setting as an int, or a fallback if it is not set or not a number
+         */
+        int getInt(const std::string& key, int fallback = 0) const;
+        /**
+         * @brief Set a string setting
+         */
+        void set(const std::string& key, const std::string& value);
+        /**
+         * @brief Set a number setting
+         */
+        void set(const std::string& key, float value);
+        /**
+         * @brief Set an integer setting
+         */
+        void set(const std::string& key, int value);
+    private:
+        std::map<std::string, std::string> values;
+};
+} // namespace kachow
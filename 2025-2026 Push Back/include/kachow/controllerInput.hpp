@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include "pros/misc.hpp"
+
+namespace kachow {
+
+/**
+ * @brief when a button binding runs its action
+ */
+enum class Trigger {
+    PRESSED, /** once, on the tick the combination becomes held */
+    RELEASED, /** once, on the tick the combination stops being held */
+    HELD, /** every tick while the combination is held */
+    DOUBLE_TAP, /** once, when the combination is pressed twice within the double tap window */
+    LONG_PRESS /** once per hold, when the combination has been held for the long press time */
+};
+
+/**
+ * @brief Samples a controller once per tick and answers button queries from that snapshot
+ *
+ * Only buttons and axes that are bound or have been queried are read from the controller, so the number of
+ * controller calls per tick is fixed by what the driver code actually uses. A button queried for the first time is
+ * sampled from the next update() onwards.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::ControllerInput driver(&master);
+ * driver.bind({DIGITAL_L1}, kachow::Trigger::PRESSED, [] { MatchLoader.toggle(); });
+ * while (true) {
+ *     driver.update();
+ *     chassis.tank(driver.getAxis(ANALOG_LEFT_Y), driver.getAxis(ANALOG_RIGHT_Y));
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class ControllerInput {
+    public:
+        using Buttons = std::bitset<12>;
+
+        /**
+         * @brief Construct a new Controller Input
+         *
+         * @param controller the controller to sample
+         * @param debounceTime how long in ms a button must read the same value before the change is accepted. 0 by
+         * default, which accepts changes immediately
+         * @param doubleTapTime max time in ms between two presses for them to count as a double tap. 300 by default
+         * @param longPressTime time in ms a button must be held to count as a long press. 500 by default
+         */
+        ControllerInput(pros::Controller* controller, uint32_t debounceTime = 0, uint32_t doubleTapTime = 300,
+                        uint32_t longPressTime = 500);
+        /**
+         * @brief Sample the controller and run any bindings that fire this tick. Call once per loop
+         */
+        void update();
+        /**
+         * @brief Feed a sample in directly. update() calls this with the controller readings
+         *
+         * @param raw raw button states, bit 0 is L1
+         * @param axes raw axis values, indexed by pros::controller_analog_e_t
+         * @param now current time in ms
+         */
+        void update(Buttons raw, std::array<int32_t, 4> axes, uint32_t now);
+        /**
+         * @brief Mark an axis to be read by poll() as well, for the inputs where a few ms of latency matter
+         */
+        void pollFast(pros::controller_analog_e_t axis);
+        /**
+         * @brief Mark buttons to be read by poll() as well, for the inputs where a few ms of latency matter
+         */
+        void pollFast(std::initializer_list<pros::controller_digital_e_t> buttons);
+        /**
+         * @brief Read only the inputs marked with pollFast, without updating the snapshot
+         *
+         * Cheap enough to call much more often than update(), since nothing else is read from the controller.
+         *
+         * @return whether any of them differ from the last update(). Always false if nothing is marked
+         */
+        bool poll();
+        /**
+         * @brief whether any sampled button or axis reading differs from the previous sample
+         *
+         * This is the earliest sign that a new controller packet has arrived
+         */
+        bool changed() const;
+        /**
+         * @brief whether a button is currently held
+         */
+        bool held(pros::controller_digital_e_t button);
+        /**
+         * @brief whether a button went down this tick
+         */
+        bool pressed(pros::controller_digital_e_t button);
+        /**
+         * @brief whether a button went up this tick
+         */
+        bool released(pros::controller_digital_e_t button);
+        /**
+         * @brief whether this tick's press was the second of a double tap
+         */
+        bool doubleTapped(pros::controller_digital_e_t button);
+        /**
+         * @brief whether the button crossed the long press time this tick
+         */
+        bool longPressed(pros::controller_digital_e_t button);
+        /**
+         * @brief whether every button in a combination is held
+         */
+        bool held(std::initializer_list<pros::controller_digital_e_t> combo);
+        /**
+         * @brief whether every button in a combination mask is held. Always false for an empty mask
+         */
+        bool held(Buttons combo);
+        /**
+         * @brief Get an axis from the snapshot, from -127 to 127
+         */
+        int32_t getAxis(pros::controller_analog_e_t axis);
+        /**
+         * @brief Bind an action to a button combination
+         *
+         * A combination is active while all of its buttons are held. Bindings are checked in the order they were
+         * added, after the snapshot is taken in update()
+         *
+         * @param combo the buttons that must be held together
+         * @param trigger when the action runs
+         * @param action the function to run
+         */
+        void bind(std::initializer_list<pros::controller_digital_e_t> combo, Trigger trigger,
+                  std::function<void()> action);
+        /**
+         * @brief Bind an action to a button combination mask. Empty masks are ignored
+         */
+        void bind(Buttons combo, Trigger trigger, std::function<void()> action);
+        /**
+         * @brief Remove all bindings
+         */
+        void clearBindings();
+    private:
+        struct Binding {
+                Buttons mask;
+                Trigger trigger;
+                std::function<void()> action;
+                uint32_t activeSince = 0;
+                uint32_t lastPress = 0;
+                bool tapPending = false;
+                bool longFired = false;
+        };
+
+        static size_t index(pros::controller_digital_e_t button);
+        static Buttons toMask(std::initializer_list<pros::controller_digital_e_t> combo);
+        bool fires(Binding& binding, uint32_t now) const;
+
+        pros::Controller* controller;
+        const uint32_t debounceTime;
+        const uint32_t doubleTapTime;
+        const uint32_t longPressTime;
+
+        Buttons watchedButtons;
+        std::bitset<4> watchedAxes;
+        Buttons fastButtons;
+        std::bitset<4> fastAxes;
+        Buttons current;
+        Buttons previous;
+        Buttons lastRaw;
+        Buttons lastSample;
+        bool inputChanged = false;
+        std::array<int32_t, 4> axes {};
+        std::array<uint32_t, 12> rawChangeTime {};
+        std::array<uint32_t, 12> pressTime {};
+        std::array<uint32_t, 12> lastPressTime {};
+        Buttons tapPending;
+        Buttons doubleTap;
+        Buttons longPress;
+        Buttons longFired;
+        std::vector<Binding> bindings;
+};
+} // namespace kachow
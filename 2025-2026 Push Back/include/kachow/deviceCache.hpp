@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include "pros/adi.hpp"
+#include "pros/motor_group.hpp"
+
+namespace kachow {
+
+/**
+ * @brief counters describing how effective a write cache has been
+ */
+struct WriteStats {
+        /** number of commands that were actually sent to the device */
+        uint32_t sent = 0;
+        /** number of commands that matched the last commanded state and were dropped */
+        uint32_t suppressed = 0;
+};
+
+/**
+ * @brief Last-commanded-state tracker shared by the cached device wrappers
+ *
+ * A write is allowed through when the value differs from the last one sent, when nothing has been sent yet, or when
+ * the refresh period has elapsed since the last real write. The periodic refresh guards against a command that was
+ * lost on the smart port / ADI bus or overwritten by code that talks to the device directly.
+ *
+ * @tparam T the commanded state. Must be equality comparable
+ */
+template <typename T> class WriteCache {
+    public:
+        /**
+         * @brief Construct a new Write Cache
+         *
+         * @param refreshPeriod time in ms after which an unchanged value is sent again. 0 disables the refresh
+         */
+        explicit WriteCache(uint32_t refreshPeriod)
+            : refreshPeriod(refreshPeriod) {}
+
+        /**
+         * @brief Decide whether a value needs to be sent, and record it if it does
+         *
+         * @param value the value about to be commanded
+         * @param now the current time in ms
+         * @return true the value should be written to the device
+         * @return false the device already has this value
+         */
+        bool update(const T& value, uint32_t now) {
+            const bool stale = refreshPeriod != 0 && now - lastWrite >= refreshPeriod;
+            if (valid && value == last && !stale) {
+                stats.suppressed++;
+                return false;
+            }
+            last = value;
+            lastWrite = now;
+            valid = true;
+            stats.sent++;
+            return true;
+        }
+
+        /**
+         * @brief Forget the last commanded value so the next write always goes through
+         *
+         * Call this after something outside the cache changed the device, e.g. LemLib setting the brake mode
+         */
+        void invalidate() { valid = false; }
+
+        /**
+         * @brief Get the last value that was sent. Only meaningful once a write has gone through
+         */
+        const T& getLast() const { return last; }
+
+        /**
+         * @brief Get the write counters
+         */
+        WriteStats getStats() const { return stats; }
+    private:
+        const uint32_t refreshPeriod;
+        T last {};
+        uint32_t lastWrite = 0;
+        bool valid = false;
+        WriteStats stats;
+};
+
+/**
+ * @brief Drop-in wrapper for a pros::MotorGroup that only sends commands which change the motor state
+ *
+ * Method names mirror the PROS API so existing call sites keep working.
+ */
+class CachedMotorGroup {
+    public:
+        /**
+         * @brief Construct a new Cached Motor Group
+         *
+         * @param motors pointer to the motor group being wrapped
+         * @param refreshPeriod time in ms after which an unchanged command is sent again. 250 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pros::MotorGroup intakeMotors({11, -20}, pros::MotorGearset::blue);
+         * kachow::CachedMotorGroup intake(&intakeMotors);
+         * @endcode
+         */
+        CachedMotorGroup(pros::MotorGroup* motors, uint32_t refreshPeriod = 250);
+        /**
+         * @brief Set the voltage of the motors, from -127 to 127
+         */
+        void move(int32_t voltage);
+        /**
+         * @brief Set the velocity target of the motors, in the gearset's rpm
+         */
+        void move_velocity(int32_t velocity);
+        /**
+         * @brief Set the voltage of the motors, in mV
+         */
+        void move_voltage(int32_t voltage);
+        /**
+         * @brief Set the brake mode of every motor in the group
+         *
+         * Unlike pros::MotorGroup::set_brake_mode, this always applies to all motors, not just the first one
+         */
+        void set_brake_mode(pros::motor_brake_mode_e_t mode);
+        /**
+         * @brief Force the next command of each kind to be sent
+         */
+        void invalidate();
+        /**
+         * @brief Get the combined write counters for movement and brake mode commands
+         */
+        WriteStats getStats() const;
+        /**
+         * @brief Get the wrapped motor group, for telemetry or anything the cache does not cover
+         */
+        pros::MotorGroup* getMotors() const;
+    private:
+        enum class CommandType { MOVE, VELOCITY, VOLTAGE };
+
+        struct Command {
+                CommandType type;
+                int32_t value;
+
+                bool operator==(const Command& other) const = default;
+        };
+
+        pros::MotorGroup* motors;
+        WriteCache<Command> command;
+        WriteCache<pros::motor_brake_mode_e_t> brakeMode;
+};
+
+/**
+ * @brief Drop-in wrapper for a pros::adi::DigitalOut that only writes when the output changes
+ */
+class CachedDigitalOut {
+    public:
+        /**
+         * @brief Construct a new Cached Digital Out
+         *
+         * @param out pointer to the digital output being wrapped
+         * @param refreshPeriod time in ms after which an unchanged value is sent again. 250 by default
+         */
+        CachedDigitalOut(pros::adi::DigitalOut* out, uint32_t refreshPeriod = 250);
+        /**
+         * @brief Set the output
+         */
+        void set_value(bool value);
+        /**
+         * @brief Get the last value written. False if nothing has been written yet
+         */
+        bool get_value() const;
+        /**
+         * @brief Invert the last value written
+         */
+        void toggle();
+        /**
+         * @brief Force the next write to be sent
+         */
+        void invalidate();
+        /**
+         * @brief Get the write counters
+         */
+        WriteStats getStats() const;
+    private:
+        pros::adi::DigitalOut* out;
+        WriteCache<bool> value;
+};
+} // namespace kachow
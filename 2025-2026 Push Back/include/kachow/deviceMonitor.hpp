@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "pros/device.hpp"
+#include "pros/imu.hpp"
+#include "pros/motor_group.hpp"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+
+namespace kachow {
+
+/**
+ * @brief what DeviceMonitor last saw on a port
+ */
+enum class DeviceStatus {
+    OK, /** plugged in and working */
+    DISCONNECTED, /** nothing is plugged into the port, or the device stopped answering */
+    WRONG_DEVICE, /** something else is plugged into the port */
+    OVER_TEMP, /** a motor hot enough that it is limiting its current */
+    FAULT /** a motor reporting a driver or over current fault */
+};
+
+/**
+ * @brief The health of one port
+ */
+struct DeviceHealth {
+        /** what the device is called in the log */
+        std::string name;
+        /** smart port, from 1 to 21 */
+        uint8_t port;
+        DeviceStatus status;
+        /** how many times the device has been unplugged, or stopped answering */
+        uint32_t disconnects;
+        /** total time spent not OK, in ms */
+        uint32_t downTime;
+        /** the motor fault flags last read, see pros::motor_fault_e_t. 0 for sensors */
+        uint32_t faults;
+};
+
+/**
+ * @brief Watches every configured port so loose cables and cooked motors are noticed instead of failing silently
+ *
+ * Every period, each port is checked with the V5 device registry to see whether the right kind of device is still
+ * plugged in, and each motor's faults and over temperature flag are read. Whenever a port's status changes it is
+ * logged, and the callbacks given to onChange run, so subsystems can switch into a degraded mode and the driver can
+ * be told.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::DeviceMonitor monitor;
+ *
+ * void initialize() {
+ *     monitor.add("drive left", &leftMotors);
+ *     monitor.add("horizontal wheel", 21, pros::DeviceType::rotation);
+ *     monitor.onChange([](const kachow::DeviceHealth& health) {
+ *         if (health.status != kachow::DeviceStatus::OK) master.rumble("-");
+ *     });
+ *     monitor.start();
+ * }
+ * @endcode
+ */
+class DeviceMonitor {
+    public:
+        /**
+         * @brief Construct a new Device Monitor
+         *
+         * @param period time between checks, in ms. 20 by default
+         */
+        explicit DeviceMonitor(uint32_t period = 20);
+        /**
+         * @brief Watch a sensor's port
+         *
+         * @param name what to call it in the log
+         * @param port smart port, from 1 to 21
+         * @param type the kind of device that should be there
+         * @param optional whether the robot may not have one fitted yet. An optional device is only watched once it
+         * has been seen on its port, and until then stays OK. false by default
+         */
+        void add(const std::string& name, uint8_t port, pros::DeviceType type, bool optional = false);
+        /**
+         * @brief Watch every motor in a group, including their faults and temperature
+         *
+         * @param name what to call the group in the log. Each motor is the name followed by its port
+         */
+        void add(const std::string& name, pros::MotorGroup* motors);
+        /**
+         * @brief Run a callback whenever a port's status changes. Runs in the monitor's task, so keep it quick
+         */
+        void onChange(std::function<void(const DeviceHealth&)> callback);
+        /**
+         * @brief Start checking. Add every device and callback first
+         */
+        void start();
+        /**
+         * @brief Get the health of every port being watched
+         */
+        std::vector<DeviceHealth> getHealth() const;
+        /**
+         * @brief Whether every port is OK
+         */
+        bool allHealthy() const;
+        /**
+         * @brief Log every port that has had a problem, e.g. at the end of a run
+         */
+        void logReport() const;
+    private:
+        // one port. Motors remember their group so the faults can be read a group at a time
+        struct Watched {
+                DeviceHealth health;
+                pros::DeviceType type;
+                pros::MotorGroup* motors;
+                size_t index;
+                bool optional;
+                // whether an optional device has been plugged in yet
+                bool seen;
+        };
+
+        void update();
+        void setStatus(Watched& watched, DeviceStatus status, uint32_t faults);
+
+        const uint32_t period;
+        std::vector<Watched> watched;
+        std::vector<std::function<void(const DeviceHealth&)>> callbacks;
+        pros::Task* task = nullptr;
+};
+
+/**
+ * @brief Drop-in pros::Rotation for a tracking wheel that keeps odometry sane when its cable comes out
+ *
+ * An unplugged rotation sensor reads PROS_ERR, which odometry takes as the wheel spinning millions of degrees. While
+ * this one is unplugged it instead reads what the tracking wheel would if the robot never slid sideways, worked out
+ * from the IMU with spinRoll. LemLib, FusedOdometry and TractionMonitor then all track the robot on the drive encoders
+ * and the IMU alone, as if there were no tracking wheel. When it is plugged back in it carries on from wherever that
+ * left it.
+ *
+ * Without setFallback it reads the last position it had until it is back.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::GuardedRotation horizontalEnc(21);
+ * lemlib::TrackingWheel horizontal(&horizontalEnc, lemlib::Omniwheel::NEW_2, -1.5);
+ *
+ * void initialize() { horizontalEnc.setFallback(&imu, lemlib::Omniwheel::NEW_2, -1.5); }
+ * @endcode
+ */
+class GuardedRotation : public pros::Rotation {
+    public:
+        /**
+         * @brief Construct a new Guarded Rotation
+         *
+         * @param port smart port, negative to reverse it, like pros::Rotation
+         */
+        explicit GuardedRotation(std::int8_t port);
+        /**
+         * @brief What to read while unplugged
+         *
+         * @param imu the IMU odometry uses
+         * @param diameter the tracking wheel's diameter, in inches
+         * @param offset how far forwards of the tracking center the tracking wheel is, in inches
+         */
+        void setFallback(pros::Imu* imu, float diameter, float offset);
+        std::int32_t get_position() const override;
+        std::int32_t reset_position() const override;
+        std::int32_t set_position(std::int32_t position) const override;
+        /**
+         * @brief Whether the sensor answered the last time it was read
+         */
+        bool isConnected() const;
+    private:
+        // what an unplugged sensor reads, from where it was when it went
+        std::int32_t fallbackPosition() const;
+
+        pros::Imu* imu = nullptr;
+        // centidegrees of wheel per degree the robot turns clockwise, left positive
+        float ticksPerDegree = 0;
+        // PROS declares the getters const, so what they track has to be mutable
+        mutable std::int32_t offset = 0;
+        mutable std::int32_t last = 0;
+        mutable double lostRotation = 0;
+        mutable bool connected = true;
+};
+} // namespace kachow
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "pros/distance.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/wallLocalizer.hpp"
+
+namespace kachow {
+
+/**
+ * @brief what DistanceLocalization has done so far
+ */
+struct LocalizationStats {
+        /** updates where at least one sensor corrected the pose */
+        uint32_t corrections;
+        /** total distance the pose has been moved, in inches */
+        float totalShift;
+        /** most recent correction */
+        Correction last;
+};
+
+/**
+ * @brief Keeps the chassis pose agreeing with distance sensors pointed at the field walls
+ *
+ * Runs a task alongside LemLib's odometry that reads every sensor each 10ms, works out a correction with a
+ * WallLocalizer and nudges the chassis pose by it with Chassis::correctPose, so a FusedOdometry takes it as a position
+ * fix. Only x and y are corrected. Manual setPose calls still work, and there is no harm in keeping the ones after wall
+ * contact.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Distance leftDistance(3);
+ * pros::Distance backDistance(4);
+ * kachow::DistanceLocalization localization(&chassis, {&leftDistance, &backDistance},
+ *                                           kachow::WallLocalizer(kachow::FieldMap(), {{-6, 0, -90}, {0, -7, 180}}));
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     localization.start();
+ * }
+ * @endcode
+ */
+class DistanceLocalization {
+    public:
+        /**
+         * @brief Construct a new Distance Localization
+         *
+         * @param chassis the chassis whose pose to correct
+         * @param sensors the distance sensors, in the same order as the localizer's mounts
+         * @param localizer where the sensors are and what they can see
+         */
+        DistanceLocalization(Chassis* chassis, std::vector<pros::Distance*> sensors, WallLocalizer localizer);
+        /**
+         * @brief Start correcting the pose. Call after chassis.calibrate()
+         */
+        void start();
+        /**
+         * @brief Pause or resume corrections, e.g. while pushing against another robot near a wall
+         */
+        void setEnabled(bool enabled);
+        LocalizationStats getStats() const;
+    private:
+        void update();
+
+        Chassis* chassis;
+        std::vector<pros::Distance*> sensors;
+        WallLocalizer localizer;
+        std::vector<DistanceReading> readings;
+        bool enabled = true;
+        LocalizationStats stats {0, 0, {0, 0, 0}};
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+
+namespace kachow {
+
+/**
+ * @brief Thresholds for DriveBalance
+ */
+struct BalanceSettings {
+        /** share of its torque a motor over its temperature limit still gives. V5 motors halve their current. 0.5 */
+        float overTempCapacity = 0.5;
+        /** how far a motor's speed may be from the rest of its side before it counts as stripped, out of 1. 0.25 */
+        float stripSpeed = 0.25;
+        /** how long it has to be that far out, in seconds. 0.3 */
+        float stripTime = 0.3;
+};
+
+/**
+ * @brief One drive motor's telemetry
+ */
+struct MotorSample {
+        /** speed as a fraction of the cartridge's free speed. NaN if the motor did not answer */
+        float velocity;
+        /** the motor is over its temperature limit */
+        bool overTemp;
+        /** the motor reports a driver or over current fault */
+        bool faulted;
+};
+
+/**
+ * @brief Works out how to keep a drivetrain driving straight when it loses motors
+ *
+ * Each motor is worth its share of its side's torque: none if it stops answering, faults, or has stripped, and less
+ * if it is over temperature. A stripped motor is one that runs at a different speed from the rest of its side, which
+ * motors geared together can't do; it needs at least three motors to a side to tell which one is out, and once found
+ * it stays out. The stronger side is then scaled down to match the weaker one, so both push equally hard and the
+ * robot does not pull to one side.
+ *
+ * If a whole side is out, scaling can't help, so nothing is scaled.
+ *
+ * Pure math with no PROS calls. DriveFailover runs it on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::DriveBalance balance;
+ * // the back left motor has come unplugged
+ * balance.update({{0.5, false, false}, {0.5, false, false}, {NAN, false, false}},
+ *                {{0.5, false, false}, {0.5, false, false}, {0.5, false, false}}, 0.02);
+ * balance.getRightScale(); // 2/3
+ * @endcode
+ */
+class DriveBalance {
+    public:
+        /**
+         * @brief Construct a new Drive Balance
+         *
+         * @param settings struct to simulate named parameters
+         */
+        explicit DriveBalance(BalanceSettings settings = {});
+        /**
+         * @brief Add a sample
+         *
+         * @param left every left motor, always in the same order
+         * @param right every right motor, always in the same order
+         * @param dt seconds since the last sample
+         */
+        void update(const std::vector<MotorSample>& left, const std::vector<MotorSample>& right, float dt);
+        /**
+         * @brief What to multiply the left side's output by, 0 to 1
+         */
+        float getLeftScale() const;
+        /**
+         * @brief What to multiply the right side's output by, 0 to 1
+         */
+        float getRightScale() const;
+        /**
+         * @brief Share of its full torque the drivetrain has once balanced, 0 to 1
+         */
+        float getCapacity() const;
+        /**
+         * @brief Share of its full torque the left side has, before balancing
+         */
+        float getLeftCapacity() const;
+        /**
+         * @brief Share of its full torque the right side has, before balancing
+         */
+        float getRightCapacity() const;
+    private:
+        // averages the capacity of every motor on a side, and keeps track of which have stripped
+        float sideCapacity(const std::vector<MotorSample>& side, std::vector<float>& stripFor, float dt);
+
+        BalanceSettings settings;
+        // how long each motor has been out of step with its side, in seconds
+        std::vector<float> leftStripFor;
+        std::vector<float> rightStripFor;
+        float leftCapacity = 1;
+        float rightCapacity = 1;
+};
+} // namespace kachow
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/motor_group.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/driveBalance.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Drop-in pros::MotorGroup whose voltage commands can be scaled down
+ *
+ * move and move_voltage are scaled, so LemLib's motions, ours and driver control all go through it. Velocity targets
+ * are left alone, since the motors' own velocity controllers already push harder on a weak side.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::BalancedMotorGroup leftMotors({-13, 15, -16}, pros::MotorGearset::blue);
+ * leftMotors.setScale(0.67);
+ * leftMotors.move(127); // sends 85
+ * @endcode
+ */
+class BalancedMotorGroup : public pros::MotorGroup {
+    public:
+        using pros::MotorGroup::MotorGroup;
+        std::int32_t move(std::int32_t voltage) const override;
+        std::int32_t move_voltage(std::int32_t voltage) const override;
+        /**
+         * @brief Set what to multiply every voltage command by, 0 to 1. Takes effect from the next command
+         */
+        void setScale(float scale);
+        float getScale() const;
+    private:
+        std::atomic<float> scale = 1;
+};
+
+/**
+ * @brief Keeps the robot driving straight when it loses drive motors
+ *
+ * Every 20ms, reads each drive motor's velocity, faults and over temperature flag and runs a DriveBalance on them.
+ * Whenever the balance changes:
+ * - the stronger side is scaled down to match the weaker one, so the robot does not pull to one side
+ * - the chassis is told how much torque is left, which slows the lateral acceleration limit and gives motions longer
+ *   to finish
+ * - the change is logged
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::DriveFailover failover(&chassis, &leftMotors, &rightMotors);
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     failover.start();
+ * }
+ * @endcode
+ */
+class DriveFailover {
+    public:
+        /**
+         * @brief Construct a new Drive Failover
+         *
+         * @param chassis the chassis driven by these motors
+         * @param left the left drive motors
+         * @param right the right drive motors
+         * @param settings struct to simulate named parameters
+         */
+        DriveFailover(Chassis* chassis, BalancedMotorGroup* left, BalancedMotorGroup* right,
+                      BalanceSettings settings = {});
+        /**
+         * @brief Start watching. Call after chassis.calibrate()
+         */
+        void start();
+        const DriveBalance& getBalance() const;
+    private:
+        void update(float dt);
+
+        Chassis* chassis;
+        BalancedMotorGroup* left;
+        BalancedMotorGroup* right;
+        DriveBalance balance;
+        // motor rpm at full speed, from the cartridges once the motors are up
+        float leftRpm = 0;
+        float rightRpm = 0;
+        float prevLeftCapacity = 1;
+        float prevRightCapacity = 1;
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include "kachow/controllerInput.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Fixed-bin histogram of latencies, in microseconds
+ *
+ * Bins are 500us wide up to 50ms, anything above lands in the last bin. No allocation, so it is safe to update from
+ * the driver control loop
+ */
+class LatencyHistogram {
+    public:
+        static constexpr uint32_t BIN_WIDTH = 500;
+        static constexpr size_t BINS = 100;
+
+        /**
+         * @brief Record a latency sample
+         *
+         * @param latency latency in microseconds
+         */
+        void add(uint32_t latency);
+        /**
+         * @brief Get a percentile of the recorded samples
+         *
+         * @param percentile value between 0 and 1
+         * @return uint32_t upper edge of the bin holding the percentile, in microseconds. 0 if nothing was recorded
+         */
+        uint32_t percentile(float percentile) const;
+        /**
+         * @brief Get the number of samples recorded
+         */
+        uint32_t count() const;
+        /**
+         * @brief Get the largest sample recorded, in microseconds
+         */
+        uint32_t max() const;
+        /**
+         * @brief Clear all samples
+         */
+        void reset();
+    private:
+        std::array<uint32_t, BINS> bins {};
+        uint32_t samples = 0;
+        uint32_t largest = 0;
+};
+
+/**
+ * @brief how the driver control loop is scheduled
+ */
+enum class LoopMode {
+    FREE_RUNNING, /** sample and command every period, using pros::delay */
+    LOW_LATENCY /** poll the fast inputs quickly and run the loop body as soon as one of them changes */
+};
+
+/**
+ * @brief Driver control loop scheduler with input-to-command latency measurement
+ *
+ * Latency is measured from the earliest time a controller change could have arrived, the sample before the one
+ * that first saw it, to the moment the loop body returns with the new motor commands sent. This is an upper bound
+ * on the true latency, tight to within one poll period.
+ *
+ * In LOW_LATENCY mode only the inputs marked with ControllerInput::pollFast are read every pollPeriod ms on
+ * delay_until, and the full sample and loop body run on the poll that sees one of them change. The body still runs at
+ * least once per period so timed logic and the other inputs keep working while the fast ones are still. This lines
+ * the body up with controller packet arrival for the inputs that matter, without reading every input that often.
+ * With nothing marked it runs like FREE_RUNNING on delay_until.
+ */
+class DriverLoop {
+    public:
+        /**
+         * @brief Construct a new Driver Loop
+         *
+         * @param input the controller snapshot, updated by the loop
+         * @param mode how the loop is scheduled
+         * @param period loop period in ms. Also the longest time between runs of the body in LOW_LATENCY mode. 10 by
+         * default
+         * @param pollPeriod fast input poll period in ms for LOW_LATENCY mode. 2 by default
+         * @param reportPeriod how often to log the latency distribution, in ms. 0 disables reporting. 0 by default
+         */
+        DriverLoop(ControllerInput* input, LoopMode mode, uint32_t period = 10, uint32_t pollPeriod = 2,
+                   uint32_t reportPeriod = 0);
+        /**
+         * @brief Run the driver control loop. Does not return
+         *
+         * @param body the work done each tick after the controller is sampled, e.g. chassis.tank()
+         */
+        [[noreturn]] void run(std::function<void()> body);
+        /**
+         * @brief Get the latency distribution recorded so far
+         */
+        const LatencyHistogram& getLatency() const;
+    private:
+        void record(uint64_t previousSample, uint64_t commandTime);
+        void report(uint32_t now);
+
+        ControllerInput* input;
+        const LoopMode mode;
+        const uint32_t period;
+        const uint32_t pollPeriod;
+        const uint32_t reportPeriod;
+        uint32_t lastReport = 0;
+        LatencyHistogram latency;
+};
+} // namespace kachow
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include "kachow/controllerInput.hpp"
+#include "kachow/lutDriveCurve.hpp"
+
+namespace kachow {
+
+/**
+ * @brief how joystick axes are turned into drivetrain commands
+ */
+enum class DriveMode {
+    TANK, /** left stick drives the left side, right stick the right side */
+    ARCADE, /** left stick throttle, right stick turn */
+    CURVATURE /** left stick throttle, right stick sets the curvature of the path */
+};
+
+/**
+ * @brief parameters of an exponential drive curve, see lemlib::ExpoDriveCurve
+ */
+struct CurveSettings {
+        /** joystick deadband out of 127 */
+        float deadband = 3;
+        /** minimum output where drivetrain will move out of 127 */
+        float minOutput = 5;
+        /** expo curve gain */
+        float gain = 1.02;
+};
+
+/**
+ * @brief a driver profile turned into the form the control loop uses directly
+ */
+struct CompiledProfile {
+        DriveMode driveMode;
+        LutDriveCurve throttleCurve;
+        LutDriveCurve steerCurve;
+        /** buttons for each named action, empty if the action is unbound */
+        std::map<std::string, ControllerInput::Buttons> bindings;
+};
+
+/**
+ * @brief Everything that changes between drivers: curves, button bindings and drive mode
+ *
+ * Profiles are stored on the SD card as kachow::Config files:
+ * @code
+ * name=dhruva
+ * driveMode=tank
+ * throttle.deadband=3
+ * throttle.minOutput=5
+ * throttle.gain=1.02
+ * bind.matchLoader=L1
+ * bind.scoreMiddle=R2+L2
+ * @endcode
+ * Button names are the PROS ones without the prefix (L1, R2, UP, A, ...), joined with + for combinations.
+ */
+struct DriverProfile {
+        std::string name = "default";
+        DriveMode driveMode = DriveMode::TANK;
+        CurveSettings throttle;
+        CurveSettings steer;
+        /** button combination text for each named action, e.g. "R2+L2" */
+        std::map<std::string, std::string> bindings;
+
+        /**
+         * @brief Load a profile from a file. Settings missing from the file keep their current values
+         *
+         * @return true the file was read
+         * @return false the file could not be opened
+         */
+        bool load(const std::string& path);
+        /**
+         * @brief Save the profile to a file
+         *
+         * @return true the file was written
+         * @return false the file could not be opened
+         */
+        bool save(const std::string& path) const;
+        /**
+         * @brief Build the lookup tables and button masks for this profile
+         *
+         * This does all of the work of switching drivers, so call it outside the control loop
+         */
+        CompiledProfile compile() const;
+        /**
+         * @brief Parse a button combination such as "R2+L2". Unknown names are ignored
+         */
+        static ControllerInput::Buttons parseButtons(const std::string& text);
+};
+} // namespace kachow
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/imu.hpp"
+#include "pros/motor_group.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/headingFusion.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Two IMUs that look like one to LemLib, with a heading that drifts less than either
+ *
+ * Runs a HeadingFusion every 10ms on both IMUs' rotation and the drive motors' velocities, so the IMUs' bias is
+ * measured whenever the robot sits still, including while it waits to be enabled. get_rotation, get_heading and the
+ * calls that set or tare them use the fused heading; reset and is_calibrating cover both IMUs. Everything else, like
+ * get_accel, comes from the first IMU.
+ *
+ * If one IMU is unplugged or keeps disagreeing, the other carries on alone.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::DualImu imu(10, 9, &leftMotors, &rightMotors);
+ * lemlib::OdomSensors sensors(nullptr, nullptr, &horizontal, nullptr, &imu);
+ *
+ * void initialize() {
+ *     imu.start();
+ *     chassis.calibrate();
+ * }
+ *
+ * void disabled() { imu.logReport(); }
+ * @endcode
+ */
+class DualImu : public pros::Imu {
+    public:
+        /**
+         * @brief Construct a new Dual Imu
+         *
+         * @param first port of the first IMU, which also answers everything that is not fused
+         * @param second port of the second IMU
+         * @param leftMotors the left drive motors, to tell when the robot is still
+         * @param rightMotors the right drive motors, to tell when the robot is still
+         * @param settings struct to simulate named parameters
+         */
+        DualImu(std::uint8_t first, std::uint8_t second, pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors,
+                HeadingFusionSettings settings = {});
+        /**
+         * @brief Start fusing. Call before chassis.calibrate(), which resets both IMUs through this one
+         */
+        void start();
+        std::int32_t reset(bool blocking = false) const override;
+        bool is_calibrating() const override;
+        double get_rotation() const override;
+        double get_heading() const override;
+        std::int32_t set_rotation(double target) const override;
+        std::int32_t set_heading(double target) const override;
+        std::int32_t tare_rotation() const override;
+        std::int32_t tare_heading() const override;
+        /**
+         * @brief Get the second IMU's port. get_port() gives the first one's
+         */
+        std::uint8_t getSecondPort() const;
+        /**
+         * @brief Get how the heading has held up since the IMUs were last reset
+         */
+        DriftReport getReport() const;
+        /**
+         * @brief Log the drift report, e.g. at the end of a run
+         */
+        void logReport() const;
+    private:
+        void update(float dt);
+
+        pros::Imu second;
+        pros::MotorGroup* leftMotors;
+        pros::MotorGroup* rightMotors;
+        HeadingFusion fusion;
+        float prevFirst = 0;
+        float prevSecond = 0;
+        // false after an IMU could not be read, so its next reading starts a new delta
+        bool firstSynced = false;
+        bool secondSynced = false;
+        // PROS declares reset and the setters const, so what they change has to be mutable
+        mutable std::atomic<bool> resetPending = false;
+        mutable std::atomic<float> offset = 0;
+        mutable std::atomic<float> rotation = 0;
+        // false while neither IMU answers, so LemLib can tell they are both missing
+        std::atomic<bool> available = true;
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
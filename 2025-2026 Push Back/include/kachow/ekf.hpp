@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+
+namespace kachow {
+
+/** 3x3 matrix, row major */
+using Matrix3 = std::array<std::array<float, 3>, 3>;
+
+/**
+ * @brief Noise model for PoseEkf
+ *
+ * Standard deviations, tuned for 10ms steps. Defaults are a starting point for our drivetrain; raise a noise if the
+ * filter trusts that sensor more than it should.
+ */
+struct EkfSettings {
+        /** drive encoder error as a fraction of the distance driven. 0.02 */
+        float encoderNoise = 0.02;
+        /** tracking wheel error as a fraction of the distance measured. 0.01 */
+        float trackingNoise = 0.01;
+        /** heading error per step from the IMU rate, in degrees. 0.01 */
+        float gyroNoise = 0.01;
+        /** error added every step even when still, in inches, so the filter never becomes certain. 0.002 */
+        float processNoise = 0.002;
+        /** forward acceleration the drive wheels can take without slipping, in in/s². 120 */
+        float slipAccel = 120;
+        /**
+         * how much the drive wheels may turn more than the IMU says the robot turned before it counts as slip, as a
+         * fraction. Drive wheels always scrub a little in turns. 0.25
+         */
+        float scrubAllowance = 0.25;
+        /**
+         * extra drive encoder error while fully slipping, as a fraction of the distance driven. Slip errors all point
+         * the same way instead of averaging out, hence so large. 1
+         */
+        float slipNoise = 1;
+        /** absolute heading measurement error, in degrees. 0.5 */
+        float headingNoise = 0.5;
+};
+
+/**
+ * @brief One 10ms worth of odometry sensor changes
+ */
+struct OdometryStep {
+        /** distance the left drive wheels turned, in inches */
+        float left;
+        /** distance the right drive wheels turned, in inches */
+        float right;
+        /** distance the horizontal tracking wheel turned, in inches, left positive like LemLib */
+        float lateral;
+        /** heading change from the IMU, in radians, clockwise positive */
+        float headingChange;
+        /** seconds since the last step */
+        float dt;
+        /** slip from a SlipDetector, 0 to 1. The filter goes with whichever is worse, this or its own guess */
+        float slip = 0;
+};
+
+/**
+ * @brief Extended Kalman filter for the robot's pose
+ *
+ * The state is x and y in inches and heading in compass radians, the same as chassis.getPose(true). Each predict step
+ * moves the pose by the drive encoders (forwards), the horizontal tracking wheel (sideways) and the IMU (heading), and
+ * grows the covariance by how much each of those can be trusted. Drive encoders are trusted less while they look like
+ * they are slipping: when they accelerate harder than the wheels can grip, or when they say the robot turned more
+ * than the IMU does. Absolute measurements, like a GPS fix or a fused heading, pull the pose back and shrink the
+ * covariance.
+ *
+ * Pure math with no PROS calls, so it can run on a computer against recorded or simulated data. FusedOdometry runs it
+ * on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::PoseEkf ekf(11.375, -1.5);
+ * ekf.reset(0, 0, 0);
+ * ekf.predict({0.5, 0.5, 0, 0, 0.01});
+ * if (ekf.positionError() > 2) {
+ *     // pose is unreliable, line up on a wall before scoring
+ * }
+ * @endcode
+ */
+class PoseEkf {
+    public:
+        /**
+         * @brief Construct a new Pose EKF
+         *
+         * @param trackWidth distance between the left and right drive wheels, in inches
+         * @param trackingOffset how far forwards of the tracking center the horizontal tracking wheel is, in inches.
+         * Same as lemlib::TrackingWheel's offset
+         * @param settings noise model
+         */
+        PoseEkf(float trackWidth, float trackingOffset, EkfSettings settings = {});
+        /**
+         * @brief Set the pose and how sure we are of it
+         *
+         * @param x inches
+         * @param y inches
+         * @param theta compass radians
+         * @param positionError standard deviation of x and y, in inches. 0.5 by default
+         * @param headingError standard deviation of the heading, in degrees. 1 by default
+         */
+        void reset(float x, float y, float theta, float positionError = 0.5, float headingError = 1);
+        /**
+         * @brief Move the pose by one step of odometry
+         */
+        void predict(const OdometryStep& step);
+        /**
+         * @brief Correct the heading with an absolute measurement
+         *
+         * @param theta compass radians
+         * @param error standard deviation, in degrees. Negative uses the settings' headingNoise
+         */
+        void updateHeading(float theta, float error = -1);
+        /**
+         * @brief Correct the position with an absolute measurement, e.g. a GPS fix
+         *
+         * @param x inches. NaN if this measurement says nothing about x, like a sensor that only sees one wall
+         * @param y inches. NaN if this measurement says nothing about y
+         * @param error standard deviation of each axis, in inches
+         */
+        void updatePosition(float x, float y, float error);
+        float getX() const;
+        float getY() const;
+        /** compass radians */
+        float getTheta() const;
+        /** covariance of x, y and theta, in inches and radians */
+        const Matrix3& getCovariance() const;
+        /**
+         * @brief standard deviation of the position along its least certain direction, in inches
+         */
+        float positionError() const;
+        /**
+         * @brief standard deviation of the heading, in degrees
+         */
+        float headingError() const;
+        /**
+         * @brief how much the drive encoders looked like they were slipping on the last step, 0 to 1
+         */
+        float getSlip() const;
+    private:
+        // one scalar measurement z of h · state
+        void update(const std::array<float, 3>& h, float innovation, float variance);
+
+        float trackWidth;
+        float trackingOffset;
+        EkfSettings settings;
+        std::array<float, 3> state {0, 0, 0};
+        Matrix3 covariance {};
+        float prevVelocity = 0;
+        float slip = 0;
+};
+} // namespace kachow
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "pros/gps.hpp"
+#include "pros/imu.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/ekf.hpp"
+#include "kachow/tractionMonitor.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Runs a PoseEkf on the robot's odometry sensors
+ *
+ * Reads the drive encoders, the horizontal tracking wheel, the IMU and, if there is one, a GPS sensor every 10ms, and
+ * keeps a pose estimate with a covariance next to LemLib's odometry. LemLib still drives the robot; this is how an
+ * auton finds out how much to trust chassis.getPose(). Whenever chassis.setPose is called, the filter starts again
+ * from the new pose.
+ *
+ * The IMU and the encoders move the pose, and a TractionMonitor's slip makes the filter trust the drive encoders less.
+ * Absolute fixes pull the pose back and shrink the covariance: GPS readings, and anything passed to
+ * chassis.correctPose with an error, like DistanceLocalization's wall corrections. With neither a GPS nor wall
+ * corrections the pose is plain odometry and the covariance only grows, so it then just says how long it has been
+ * since the last setPose.
+ *
+ * With a GPS, setCorrectChassis(true) writes the filtered position back into the chassis so the GPS fixes reach the
+ * motion controllers too.
+ *
+ * Every step can be recorded to the SD card and replayed on a computer with tools/ekfReplay.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::FusedOdometry fused(&chassis, &horizontal, &imu);
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     fused.start();
+ * }
+ *
+ * void autonomous() {
+ *     chassis.moveToPoint(24, 48, 2000);
+ *     chassis.waitUntilDone();
+ *     // not sure enough of the pose to score, square up on the wall first
+ *     if (fused.getEkf().positionError() > 2) lineUpOnWall();
+ * }
+ * @endcode
+ */
+class FusedOdometry {
+    public:
+        /**
+         * @brief Construct a new Fused Odometry
+         *
+         * @param chassis the chassis whose pose to follow. Its drivetrain gives the drive motors, wheel size and track
+         * width
+         * @param horizontal the horizontal tracking wheel, or nullptr if there is none
+         * @param imu the IMU LemLib uses
+         * @param gps a GPS sensor set up to report the tracking center, or nullptr if there is none. nullptr by default
+         * @param settings noise model
+         */
+        FusedOdometry(Chassis* chassis, lemlib::TrackingWheel* horizontal, pros::Imu* imu, pros::Gps* gps = nullptr,
+                      EkfSettings settings = {});
+        /**
+         * @brief Start filtering. Call after chassis.calibrate()
+         */
+        void start();
+        /**
+         * @brief Write the filtered position into the chassis each step. Only worth it with a GPS. Off by default
+         */
+        void setCorrectChassis(bool correct);
+        /**
+         * @brief Trust the drive encoders less whenever this monitor says they are slipping, on top of the filter's
+         * own guess. nullptr by default
+         */
+        void setTractionMonitor(const TractionMonitor* monitor);
+        /**
+         * @brief Record every step to a CSV file on the SD card, for tools/ekfReplay
+         *
+         * Each row has the step's time, dt, sensor changes and slip, any wall or GPS fix the filter took, and LemLib's
+         * pose
+         *
+         * @return true if the file could be opened
+         */
+        bool startRecording(const std::string& path);
+        void stopRecording();
+        /**
+         * @brief A copy of the filter, taken under a lock so any task can read it. Read its pose, covariance and slip
+         * from here
+         */
+        PoseEkf getEkf() const;
+        /**
+         * @brief longest a step has taken, in microseconds. Needs to stay well under the 10ms period
+         */
+        uint32_t getMaxStepTime() const;
+    private:
+        void step(uint32_t now);
+
+        Chassis* chassis;
+        // the drive wheels, made in start()
+        lemlib::TrackingWheel* left = nullptr;
+        lemlib::TrackingWheel* right = nullptr;
+        lemlib::TrackingWheel* horizontal;
+        pros::Imu* imu;
+        pros::Gps* gps;
+        const TractionMonitor* traction = nullptr;
+        EkfSettings settings;
+        PoseEkf ekf;
+        bool correctChassis = false;
+        FILE* recording = nullptr;
+        float prevLeft = 0;
+        float prevRight = 0;
+        float prevLateral = 0;
+        float prevRotation = 0;
+        // false after a step the sensors could not be read
+        bool synced = false;
+        // set by setPose and correctPose from other tasks, picked up on the next step
+        bool resetPending = false;
+        lemlib::Pose resetPose {0, 0, 0};
+        bool fixPending = false;
+        PoseCorrection fix {{0, 0, 0}, 0, 0, 0};
+        // held while the filter, what is pending for it or the recording is used
+        mutable pros::Mutex mutex;
+        uint32_t prevTime = 0;
+        uint32_t maxStepTime = 0;
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kachow {
+
+/**
+ * @brief PID gains for one entry of a gain schedule
+ */
+struct Gains {
+        float kP;
+        float kI;
+        float kD;
+};
+
+/**
+ * @brief PID gains that change with how far the controller has to go and how fast it is already going
+ *
+ * One set of gains has to be soft enough not to overshoot a 180° turn and stiff enough to finish a 10° correction. A
+ * schedule holds a grid of gains keyed on the size of the error and the current speed, and interpolates between the
+ * grid points, so the gains change smoothly as a turn closes in. Both keys are used as magnitudes, and values outside
+ * the grid use the nearest edge.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // stiffer for small corrections, more damping when already turning fast
+ * kachow::GainSchedule schedule({10, 45, 180}, // error breakpoints, degrees
+ *                               {0, 300}, // angular velocity breakpoints, degrees per second
+ *                               {{3, 0, 12}, {3, 0, 16}, // 10 degrees
+ *                                {2, 0, 10}, {2, 0, 14}, // 45 degrees
+ *                                {1.5, 0, 8}, {1.5, 0, 12}}); // 180 degrees
+ * @endcode
+ */
+class GainSchedule {
+    public:
+        /**
+         * @brief Construct a new Gain Schedule
+         *
+         * @param errors error breakpoints, increasing
+         * @param velocities velocity breakpoints, increasing
+         * @param gains one entry per breakpoint pair, all the velocities for the first error, then the second...
+         */
+        GainSchedule(std::vector<float> errors, std::vector<float> velocities, std::vector<Gains> gains);
+        /**
+         * @brief Same gains everywhere, for a schedule that is yet to be tuned
+         *
+         * @param errors error breakpoints, used to split tuning results into bands
+         */
+        GainSchedule(std::vector<float> errors, Gains gains);
+        /**
+         * @brief Interpolated gains for an error and velocity
+         */
+        Gains lookup(float error, float velocity) const;
+        /**
+         * @brief which error band an error falls in: 0 up to the first breakpoint, 1 up to the second, and so on
+         */
+        size_t band(float error) const;
+        /**
+         * @brief number of error bands, one more than the number of error breakpoints
+         */
+        size_t bands() const;
+        /**
+         * @brief error breakpoints
+         */
+        const std::vector<float>& getErrors() const;
+        /**
+         * @brief Set every entry to the same gains, e.g. to start tuning the bands again from an autotune
+         *
+         * Not safe to call while a motion is using the schedule
+         */
+        void fill(Gains gains);
+    private:
+        std::vector<float> errors;
+        std::vector<float> velocities;
+        std::vector<Gains> gains;
+};
+
+/**
+ * @brief A PID controller that looks its gains up in a schedule every update
+ *
+ * Behaves like lemlib::PID otherwise, including the integral windup range and resetting the integral when the error
+ * changes sign
+ */
+class ScheduledPID {
+    public:
+        /**
+         * @brief Construct a new Scheduled PID
+         *
+         * @param schedule the gains to use. Must outlive the controller
+         * @param windupRange integral anti windup range
+         * @param signFlipReset whether to reset integral when sign of error flips
+         */
+        ScheduledPID(const GainSchedule& schedule, float windupRange = 0, bool signFlipReset = false);
+        /**
+         * @brief Update the PID
+         *
+         * @param error target minus position
+         * @param velocity how fast the position is changing, in error units per second
+         * @return float output
+         */
+        float update(float error, float velocity);
+        /**
+         * @brief reset the integral and derivative
+         */
+        void reset();
+    private:
+        const GainSchedule& schedule;
+        const float windupRange;
+        const bool signFlipReset;
+        float integral = 0;
+        float prevError = 0;
+        bool first = true;
+};
+
+/**
+ * @brief how one turn went
+ */
+struct TurnResult {
+        /** size of the turn, in degrees */
+        float turn;
+        /** ms from the start until the error stayed within the settle range */
+        uint32_t settleTime;
+        /** how far past the target the robot went, in degrees. 0 if it never crossed */
+        float overshoot;
+        /** error when the motion ended, in degrees */
+        float finalError;
+        /** fastest turning speed, in degrees per second */
+        float peakVelocity;
+};
+
+/**
+ * @brief Measures the response of a turn as it happens
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::TurnMetrics metrics(1);
+ * metrics.start(error, pros::millis());
+ * while (turning) {
+ *     metrics.update(error, velocity, pros::millis());
+ * }
+ * kachow::TurnResult result = metrics.finish();
+ * @endcode
+ */
+class TurnMetrics {
+    public:
+        /**
+         * @brief Construct a new Turn Metrics
+         *
+         * @param settleRange error in degrees that counts as settled
+         */
+        explicit TurnMetrics(float settleRange);
+        void start(float error, uint32_t now);
+        void update(float error, float velocity, uint32_t now);
+        TurnResult finish() const;
+    private:
+        const float settleRange;
+        TurnResult result {};
+        uint32_t startTime = 0;
+        /** when the error last entered the settle range, 0 if it is outside */
+        uint32_t settledSince = 0;
+        bool settled = false;
+        float direction = 1;
+};
+
+/**
+ * @brief Average turn results for each band of a gain schedule
+ */
+class TuningLog {
+    public:
+        explicit TuningLog(size_t bands);
+        void record(size_t band, const TurnResult& result);
+        /**
+         * @brief number of turns recorded in a band
+         */
+        size_t count(size_t band) const;
+        /**
+         * @brief average of all the turns recorded in a band. All zero if there are none
+         */
+        TurnResult average(size_t band) const;
+    private:
+        std::vector<size_t> counts;
+        std::vector<TurnResult> totals;
+};
+} // namespace kachow
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include "kachow/config.hpp"
+
+namespace kachow {
+
+/**
+ * @brief The measurements odometry depends on
+ *
+ * These are the effective values, which is what odometry needs: the track width includes wheel scrub and the wheel
+ * diameters include tread squish and wear, so they usually differ a little from what a ruler says.
+ */
+struct OdometryGeometry {
+        /** distance between the left and right drive wheels, in inches */
+        float trackWidth;
+        /** drive wheel diameter, in inches */
+        float driveDiameter;
+        /** horizontal tracking wheel diameter, in inches */
+        float trackingDiameter;
+        /** how far forwards of the tracking center the horizontal tracking wheel is, in inches */
+        float trackingOffset;
+};
+
+/**
+ * @brief One spin in place, as measured with the geometry at the time
+ */
+struct SpinMeasurement {
+        /** distance the left drive wheels turned, in inches */
+        float left;
+        /** distance the right drive wheels turned, in inches */
+        float right;
+        /** distance the horizontal tracking wheel turned, in inches, left positive like LemLib */
+        float lateral;
+        /** how far the IMU says the robot turned, in radians, clockwise positive */
+        float rotation;
+};
+
+/**
+ * @brief One straight run, as measured with the geometry at the time
+ */
+struct StraightMeasurement {
+        /** distance the left drive wheels turned, in inches */
+        float left;
+        /** distance the right drive wheels turned, in inches */
+        float right;
+};
+
+/**
+ * @brief Works out the effective odometry geometry from calibration runs
+ *
+ * Straight runs into a wall a known distance away give the drive wheel diameter, and sliding the robot left a known
+ * distance gives the tracking wheel diameter. Spinning in place gives the track width, from how far the drive wheels
+ * turned for each turn of the IMU, and the tracking wheel offset, from how far the tracking wheel rolled sideways
+ * (see spinRoll). Each value is a least squares fit over every run of its kind. Spinning as much each way cancels the
+ * IMU's drift, which adds to the turns one way and takes from the other, and averaging several spins evens out
+ * start-up jerk. The IMU's own scale error does not cancel, so the track width is only as good as the IMU.
+ *
+ * Measurements are taken with whatever geometry the robot was using, which is passed to the constructor, so
+ * calibrating again with the results refines them instead of starting over. Anything with no runs keeps its current
+ * value, and so does a diameter whose runs read backwards, since a negative diameter can't be right.
+ *
+ * Pure math with no PROS calls. Chassis::measureSpin and Chassis::measureWallRun take the measurements.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::GeometrySolver solver(geometry);
+ * solver.addSpin(chassis.measureSpin(3));
+ * solver.addSpin(chassis.measureSpin(-3));
+ * solver.addStraight(chassis.measureWallRun(), 48);
+ * geometry = solver.solve();
+ * @endcode
+ */
+class GeometrySolver {
+    public:
+        /**
+         * @brief Construct a new Geometry Solver
+         *
+         * @param current the geometry the measurements are taken with
+         */
+        explicit GeometrySolver(OdometryGeometry current);
+        void addSpin(const SpinMeasurement& spin);
+        /**
+         * @param straight the run
+         * @param distance how far the robot really went, measured with a tape, in inches
+         */
+        void addStraight(const StraightMeasurement& straight, float distance);
+        /**
+         * @param lateral distance the horizontal tracking wheel turned, in inches, left positive like LemLib
+         * @param distance how far the robot really went left, measured with a tape, in inches
+         */
+        void addSlide(float lateral, float distance);
+        /**
+         * @brief The best fit geometry for every run so far
+         */
+        OdometryGeometry solve() const;
+        /**
+         * @brief How much the spins disagree about the track width, as a standard deviation in inches
+         *
+         * More than a few hundredths means the drive wheels slipped in some spins; spin slower
+         */
+        float spinSpread() const;
+        /**
+         * @brief Whether the slides read the tracking wheel backwards, so its diameter was left as it was
+         *
+         * Either the robot went right instead of left, or the rotation sensor is reversed the wrong way for LemLib
+         */
+        bool isSlideBackwards() const;
+        int getSpins() const;
+    private:
+        float driveScale() const;
+        float trackingScale() const;
+
+        OdometryGeometry current;
+        // least squares sums, for true = scale * measured and distance = width * rotation
+        double straightTrue = 0, straightSquares = 0;
+        double slideTrue = 0, slideSquares = 0;
+        double spinWidth = 0, spinOffset = 0, spinSquares = 0;
+        // for the spread, track width per spin at the current drive scale
+        double widthSum = 0, widthSquares = 0;
+        int spins = 0;
+};
+
+/**
+ * @brief How far the horizontal tracking wheel reads when the robot spins in place, the way LemLib counts it
+ *
+ * LemLib's odometry takes the horizontal wheel as left positive. A wheel ahead of the tracking center rolls right as
+ * the robot turns clockwise, so it reads -offset inches per radian, which LemLib's arc correction then cancels out.
+ *
+ * @param offset how far forwards of the tracking center the wheel is, in inches
+ * @param rotation how far the robot turned, in radians, clockwise positive
+ * @return float distance the wheel reads, in inches, left positive
+ */
+float spinRoll(float offset, float rotation);
+
+/**
+ * @brief spinRoll in rotation sensor centidegrees per degree the robot turns clockwise
+ *
+ * @param diameter the tracking wheel's diameter, in inches
+ * @param offset how far forwards of the tracking center the wheel is, in inches
+ */
+float spinTicksPerDegree(float diameter, float offset);
+
+/**
+ * @brief Store a geometry in a config as <prefix>.trackWidth, <prefix>.driveDiameter and so on
+ */
+void saveGeometry(Config& config, const std::string& prefix, const OdometryGeometry& geometry);
+
+/**
+ * @brief Read a geometry stored by saveGeometry
+ *
+ * @return true if all four were set, in which case geometry is filled in
+ */
+bool loadGeometry(const Config& config, const std::string& prefix, OdometryGeometry& geometry);
+} // namespace kachow
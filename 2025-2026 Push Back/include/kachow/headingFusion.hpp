@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+
+namespace kachow {
+
+/**
+ * @brief Thresholds for HeadingFusion
+ */
+struct HeadingFusionSettings {
+        /** how far apart the two IMUs' turn rates may be before the odd one out is ignored, in deg/s. 5 */
+        float outlierRate = 5;
+        /** an IMU ignored for this many samples in a row is dropped for the rest of the run. 50 */
+        int maxOutliers = 50;
+        /** turn rate below which the robot counts as still, as long as the drive wheels are too, in deg/s. 1 */
+        float stillRate = 1;
+        /** how long the robot has to be still before the IMUs' bias is measured, in seconds. 0.25 */
+        float settleTime = 0.25;
+        /** how quickly the bias estimates follow what the IMUs read while still, in seconds. 2 */
+        float biasTime = 2;
+        /** largest bias believed, so a slow push is not learned as drift, in deg/s. 0.5 */
+        float maxBias = 0.5;
+};
+
+/**
+ * @brief One sample's worth of readings from both IMUs
+ */
+struct HeadingSample {
+        /** how far the first IMU's rotation changed since the last sample, in degrees. NaN if it could not be read */
+        float first;
+        /** how far the second IMU's rotation changed since the last sample, in degrees. NaN if it could not be read */
+        float second;
+        /** whether the drive wheels are still */
+        bool wheelsStill;
+        /** seconds since the last sample */
+        float dt;
+};
+
+/**
+ * @brief How the heading held up over a run
+ */
+struct DriftReport {
+        /** seconds of samples */
+        float runTime;
+        /** seconds spent still, with the heading held */
+        float stillTime;
+        /** how far the first IMU on its own ended up from the fused heading, in degrees */
+        float firstDrift;
+        /** how far the second IMU on its own ended up from the fused heading, in degrees */
+        float secondDrift;
+        /** the first IMU's bias estimate, in deg/s */
+        float firstBias;
+        /** the second IMU's bias estimate, in deg/s */
+        float secondBias;
+        /** how many samples had an IMU ignored */
+        uint32_t outliers;
+        /** the first IMU was dropped for disagreeing too long */
+        bool firstDropped;
+        /** the second IMU was dropped for disagreeing too long */
+        bool secondDropped;
+};
+
+/**
+ * @brief Fuses the rotation from two IMUs into one heading that drifts less than either
+ *
+ * Each sample, the IMUs' turn rates are averaged, which halves the variance of their noise. If they disagree by more
+ * than outlierRate, the one further from the last fused rate is ignored, since the robot cannot change how fast it is
+ * turning that quickly. An IMU that keeps being ignored, or cannot be read, is left out and the other carries on
+ * alone.
+ *
+ * Most of the drift over a run is gyro bias, so whenever the drive wheels and both IMUs have been still for
+ * settleTime, whatever the IMUs read is learned as each one's bias and subtracted from then on. While still, the
+ * fused heading is also held exactly where it is. Robots spend a lot of a skills run still, scoring or waiting on
+ * match loads, so this takes out most of the drift that builds up.
+ *
+ * Pure math with no PROS calls. DualImu runs it on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::HeadingFusion fusion;
+ * fusion.update({0.52, 0.55, false, 0.01});
+ * float heading = fusion.getHeading();
+ * @endcode
+ */
+class HeadingFusion {
+    public:
+        /**
+         * @brief Construct a new Heading Fusion
+         *
+         * @param settings struct to simulate named parameters
+         */
+        explicit HeadingFusion(HeadingFusionSettings settings = {});
+        /**
+         * @brief Add a sample
+         *
+         * @return float how far the fused heading changed, in degrees
+         */
+        float update(const HeadingSample& sample);
+        /**
+         * @brief Get the fused rotation, in degrees. Like pros::Imu::get_rotation it is not wrapped
+         */
+        float getHeading() const;
+        /**
+         * @brief Move the fused heading without touching the bias estimates or the report
+         */
+        void setHeading(float heading);
+        /**
+         * @brief Whether the robot has been still long enough that the heading is being held
+         */
+        bool isStill() const;
+        DriftReport getReport() const;
+        /**
+         * @brief Start over, for when the IMUs are recalibrated
+         */
+        void reset();
+    private:
+        // one IMU's share of the fusion
+        struct Source {
+                float bias = 0;
+                // this IMU's own heading, summed from everything it read
+                float heading = 0;
+                int outliers = 0;
+                bool dropped = false;
+        };
+
+        HeadingFusionSettings settings;
+        Source first;
+        Source second;
+        float heading = 0;
+        float prevRate = 0;
+        float stillFor = 0;
+        float runTime = 0;
+        float stillTime = 0;
+        uint32_t outliers = 0;
+};
+} // namespace kachow
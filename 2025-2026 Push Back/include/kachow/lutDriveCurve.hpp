@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+// driveCurve.hpp has no include guard, chassis.hpp pulls it in once
+#include "lemlib/chassis/chassis.hpp"
+
+namespace kachow {
+
+/**
+ * @brief Drive curve backed by a 255 entry lookup table covering every joystick value from -127 to 127
+ *
+ * The table holds the same mapping as lemlib::ExpoDriveCurve, so curves tuned for one can be used with the other.
+ * It is filled once at construction, at compile time when the object is constinit, and curve() is then a single
+ * table read. A curve can be replaced at runtime by assigning a new LutDriveCurve to it, which lets the chassis keep
+ * its pointer while the driver profile changes.
+ *
+ * see https://www.desmos.com/calculator/umicbymbnl for an interactive graph of the mapping
+ *
+ * @b Example
+ * @code {.cpp}
+ * // table built at compile time
+ * constinit kachow::LutDriveCurve throttleCurve(3, 5, 1.02);
+ * // later, switch to a different driver's curve
+ * throttleCurve = kachow::LutDriveCurve(5, 10, 1.019);
+ * @endcode
+ */
+class LutDriveCurve : public lemlib::DriveCurve {
+    public:
+        /**
+         * @brief Construct a new Lut Drive Curve and fill its table
+         *
+         * @param deadband range where input is considered to be 0
+         * @param minOutput the minimum output that can be returned
+         * @param curve how "curved" the graph is
+         */
+        constexpr LutDriveCurve(float deadband, float minOutput, float curve) {
+            for (int i = -127; i <= 127; i++) table[i + 127] = expo(i, deadband, minOutput, curve);
+        }
+
+        /**
+         * @brief curve an input using the table
+         *
+         * @param input joystick value. Rounded to the nearest integer and clamped to -127 to 127
+         * @return float the curved output
+         */
+        float curve(float input) override {
+            if (input > 127) input = 127;
+            if (input < -127) input = -127;
+            return table[int(input + (input < 0 ? -0.5f : 0.5f)) + 127];
+        }
+
+        /**
+         * @brief Evaluate the exponential curve directly, without the table
+         *
+         * This is the reference the table is built from and matches lemlib::ExpoDriveCurve::curve
+         *
+         * @param input the input to curve
+         * @param deadband range where input is considered to be 0
+         * @param minOutput the minimum output that can be returned
+         * @param curveGain how "curved" the graph is
+         * @return float the curved output
+         */
+        static constexpr float expo(float input, float deadband, float minOutput, float curveGain) {
+            const float magnitude = input < 0 ? -input : input;
+            if (magnitude <= deadband) return 0;
+            const float sign = input < 0 ? -1 : 1;
+            const double g = magnitude - deadband;
+            const double g127 = 127 - deadband;
+            const double i = pow(curveGain, g - 127) * g;
+            const double i127 = pow(curveGain, g127 - 127) * g127;
+            return sign * ((127.0 - minOutput) / 127 * i * 127 / i127 + minOutput);
+        }
+    private:
+        /**
+         * @brief constexpr base^exponent for a positive base, via exp(exponent * ln(base))
+         *
+         * std::pow is not usable in constant expressions, so this uses series that converge quickly over the range
+         * drive curves need
+         */
+        static constexpr double pow(double base, double exponent) { return exp(exponent * ln(base)); }
+
+        static constexpr double ln(double x) {
+            // ln(x) = 2 * atanh((x - 1) / (x + 1)), converges fast for x near 1
+            const double y = (x - 1) / (x + 1);
+            const double y2 = y * y;
+            double term = y;
+            double sum = 0;
+            for (int n = 1; n < 60; n += 2) {
+                sum += term / n;
+                term *= y2;
+            }
+            return 2 * sum;
+        }
+
+        static constexpr double exp(double x) {
+            // halve the argument until it is small, sum the series, then square back up
+            int squarings = 0;
+            while (x > 0.5 || x < -0.5) {
+                x /= 2;
+                squarings++;
+            }
+            double term = 1;
+            double sum = 1;
+            for (int n = 1; n < 20; n++) {
+                term *= x / n;
+                sum += term;
+            }
+            while (squarings-- > 0) sum *= sum;
+            return sum;
+        }
+
+        std::array<float, 255> table {};
+};
+} // namespace kachow
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "lemlib/asset.hpp"
+
+namespace kachow {
+
+/**
+ * @brief one point of a binary path asset
+ *
+ * Angles are in radians, standard position (counterclockwise from +x), matching Chassis::getPose(true, true)
+ */
+struct PathPoint {
+        float x;
+        float y;
+        /** direction of travel at this point */
+        float heading;
+        /** signed curvature in 1/in, positive when the path turns left */
+        float curvature;
+        /** target speed, 0-127 like LemLib's text paths. 0 on the last point */
+        float velocity;
+        /** distance along the path from the first point, in inches */
+        float distance;
+};
+
+/**
+ * @brief header at the start of a binary path asset, followed by `count` PathPoints
+ */
+struct PathHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t count;
+        /** total length of the path in inches */
+        float length;
+        uint32_t reserved;
+};
+
+/** "KPTH" read as a little endian uint32 */
+constexpr uint32_t PATH_MAGIC = 0x4854504b;
+constexpr uint16_t PATH_VERSION = 1;
+
+static_assert(sizeof(PathPoint) == 24, "binary path layout changed, bump PATH_VERSION and rebuild the assets");
+static_assert(sizeof(PathHeader) == 16, "binary path layout changed, bump PATH_VERSION and rebuild the assets");
+
+/**
+ * @brief Read-only view of a binary path asset, reading straight out of the asset buffer
+ *
+ * The .kpath files are built from the LemLib text paths in static/ by tools/pathgen.cpp during the asset step
+ * of the build, so nothing is parsed or allocated when a path starts. objcopy does not align asset data, so points are
+ * copied out one at a time instead of reinterpreting the buffer.
+ *
+ * @b Example
+ * @code {.cpp}
+ * ASSET(example_kpath); // built from static/example.txt
+ * kachow::PathView path(example_kpath);
+ * chassis.follow(path, 15, 4000);
+ * @endcode
+ */
+class PathView {
+    public:
+        /**
+         * @brief Construct a view over an asset. The view is invalid if the asset is not a binary path
+         */
+        explicit PathView(const asset& file);
+        /**
+         * @brief Construct a view over a buffer holding a binary path
+         */
+        PathView(const uint8_t* buffer, size_t size);
+        /**
+         * @brief whether the buffer held a binary path of a version this code understands
+         */
+        bool isValid() const;
+        /**
+         * @brief number of points. 0 if the view is invalid
+         */
+        size_t size() const;
+        /**
+         * @brief total length of the path in inches
+         */
+        float length() const;
+        /**
+         * @brief Get a point. The index must be less than size()
+         */
+        PathPoint operator[](size_t index) const;
+    private:
+        const uint8_t* points = nullptr;
+        size_t count = 0;
+        float pathLength = 0;
+};
+} // namespace kachow
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include "kachow/path.hpp"
+#include "kachow/splinePath.hpp"
+
+namespace kachow {
+
+/**
+ * @brief what the pure pursuit controller wants the drivetrain to do this iteration
+ */
+struct PursuitCommand {
+        /** curvature of the arc to the lookahead point, in 1/in. Positive turns left */
+        float curvature;
+        /** target speed from the closest path point, 0-127 */
+        float velocity;
+        /** index of the path point closest to the robot */
+        size_t closest;
+        /** whether the robot has reached the end of the path */
+        bool done;
+};
+
+/**
+ * @brief Pure pursuit path tracking over a binary path
+ *
+ * This is the same algorithm as lemlib::Chassis::follow: find the closest point, find where the lookahead circle
+ * crosses the path past it, and drive the arc to that point at the closest point's speed. It has no hardware
+ * dependencies so it can be run on the host.
+ *
+ * Both searches only move forwards from where the last iteration left off, and only look a fixed distance along the
+ * path, so an iteration costs the same on a 100 point path as on a 10,000 point skills path. The window has to cover
+ * how far the robot can get along the path in one iteration plus the lookahead distance, which the default of twice
+ * the lookahead distance does comfortably at 10ms per iteration. See tools/pursuitBench.cpp.
+ */
+class PurePursuit {
+    public:
+        /**
+         * @brief Construct a new Pure Pursuit controller
+         *
+         * @param path the path to follow. Must be valid and outlive the controller
+         * @param lookahead lookahead distance in inches
+         * @param window how far along the path past the last closest point to search, in inches. 0 uses twice the
+         * lookahead distance
+         */
+        PurePursuit(const PathView& path, float lookahead, float window = 0);
+        /**
+         * @brief Run one iteration
+         *
+         * @param x robot x, in inches
+         * @param y robot y, in inches
+         * @param theta direction the robot is driving in, radians in standard position
+         * @return PursuitCommand
+         */
+        PursuitCommand update(float x, float y, float theta);
+        /**
+         * @brief Curvature of the arc from a pose to the lookahead point the last update found
+         *
+         * Lets the path be tracked from one pose and steered from another, like a latency-predicted one
+         *
+         * @param x robot x, in inches
+         * @param y robot y, in inches
+         * @param theta direction the robot is driving in, radians in standard position
+         * @return float curvature in 1/in. Positive turns left
+         */
+        float curvatureFrom(float x, float y, float theta) const;
+        /**
+         * @brief Start over from the beginning of the path
+         */
+        void reset();
+        /**
+         * @brief distance along the path of the closest point, in inches
+         */
+        float getDistanceTraveled() const;
+    private:
+        size_t findClosest(float x, float y);
+        void findLookahead(float x, float y, size_t closest);
+
+        const PathView& path;
+        const float lookahead;
+        const float window;
+        size_t closestIndex = 0;
+        float lookaheadX = 0;
+        float lookaheadY = 0;
+        size_t lookaheadIndex = 0;
+        float distanceTraveled = 0;
+};
+
+/**
+ * @brief Pure pursuit path tracking over a spline path
+ *
+ * The same controller as PurePursuit, but the closest point and the lookahead point are found on the spline itself
+ * instead of on a list of points, so both land anywhere along the path rather than on or between stored points. Both
+ * searches are windowed and only move forwards, like PurePursuit.
+ */
+class SplinePursuit {
+    public:
+        /**
+         * @brief Construct a new Spline Pursuit controller
+         *
+         * @param path the path to follow. Must be valid and outlive the controller
+         * @param lookahead lookahead distance in inches
+         * @param window how far along the path past the last closest point to search, in inches. 0 uses twice the
+         * lookahead distance
+         */
+        SplinePursuit(const SplinePath& path, float lookahead, float window = 0);
+        /**
+         * @brief Run one iteration
+         *
+         * @param x robot x, in inches
+         * @param y robot y, in inches
+         * @param theta direction the robot is driving in, radians in standard position
+         * @return PursuitCommand. closest is the segment the closest point is on
+         */
+        PursuitCommand update(float x, float y, float theta);
+        /**
+         * @brief Curvature of the arc from a pose to the lookahead point the last update found
+         *
+         * Lets the path be tracked from one pose and steered from another, like a latency-predicted one
+         *
+         * @param x robot x, in inches
+         * @param y robot y, in inches
+         * @param theta direction the robot is driving in, radians in standard position
+         * @return float curvature in 1/in. Positive turns left
+         */
+        float curvatureFrom(float x, float y, float theta) const;
+        /**
+         * @brief Start over from the beginning of the path
+         */
+        void reset();
+        /**
+         * @brief distance along the path of the closest point, in inches
+         */
+        float getDistanceTraveled() const;
+    private:
+        float findClosest(float x, float y);
+        void findLookahead(float x, float y);
+
+        const SplinePath& path;
+        const float lookahead;
+        const float window;
+        float closestDistance = 0;
+        float lookaheadDistance = 0;
+        PathPoint lookaheadPoint {};
+};
+
+/**
+ * @brief Find where the segment from a to b crosses a circle
+ *
+ * @return float how far along the segment the crossing is, from 0 to 1, preferring the one closer to b. -1 if the
+ * segment does not cross the circle
+ */
+float circleIntersect(float ax, float ay, float bx, float by, float cx, float cy, float radius);
+
+/**
+ * @brief Curvature of the arc from a pose to a point, tangent to the pose's heading
+ *
+ * @param theta heading in radians, standard position
+ * @return float signed curvature in 1/in, positive when the point is to the left
+ */
+float arcCurvature(float x, float y, float theta, float targetX, float targetY);
+} // namespace kachow
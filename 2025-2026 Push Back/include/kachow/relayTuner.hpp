@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include "kachow/gainSchedule.hpp"
+
+namespace kachow {
+
+/**
+ * @brief how to turn the ultimate gain and period from a relay test into PID gains
+ *
+ * Ordered from most to least aggressive. The controllers on this robot have always run without kI, which is what PD
+ * gives.
+ */
+enum class TuningRule {
+    ZIEGLER_NICHOLS, /** classic PID, fast with a fair amount of overshoot */
+    PESSEN_INTEGRAL, /** PID, faster than Ziegler-Nichols with less overshoot on setpoint changes */
+    PD, /** Ziegler-Nichols PD, no integral */
+    SOME_OVERSHOOT, /** PID, softer */
+    NO_OVERSHOOT /** PID, softest */
+};
+
+/**
+ * @brief what a relay test measured
+ */
+struct RelayResult {
+        /** whether the test finished and saw a usable oscillation */
+        bool valid;
+        /** output per unit of error at which the loop would oscillate on its own */
+        float ultimateGain;
+        /** period of that oscillation, in seconds */
+        float ultimatePeriod;
+        /** average amplitude of the oscillation, in error units */
+        float amplitude;
+};
+
+/**
+ * @brief Åström–Hägglund relay feedback test
+ *
+ * Instead of a PID, the loop is driven by a relay: full positive output while the error is positive, full negative
+ * while it is negative, with a little hysteresis so noise does not chatter it. Any mechanism with some lag settles into
+ * a steady oscillation, and the size and period of that oscillation give the ultimate gain and period, which is all the
+ * classic tuning rules need. The first few cycles are ignored while the oscillation settles.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::RelayTuner tuner(40, 1);
+ * while (!tuner.done()) {
+ *     motor.move(tuner.update(target - position(), pros::millis()));
+ *     pros::delay(10);
+ * }
+ * kachow::Gains gains = kachow::relayGains(tuner.result(), kachow::TuningRule::PD, 0.01);
+ * @endcode
+ */
+class RelayTuner {
+    public:
+        /**
+         * @brief Construct a new Relay Tuner
+         *
+         * @param relay output while the relay is on, in the same units the controller will output
+         * @param hysteresis how far past zero the error has to go to switch the relay, in error units
+         * @param cycles how many cycles to measure
+         * @param settleCycles how many cycles to ignore first
+         */
+        RelayTuner(float relay, float hysteresis = 0, int cycles = 5, int settleCycles = 2);
+        /**
+         * @brief Run one iteration
+         *
+         * @param error target minus position
+         * @param now time in ms
+         * @return float output to apply
+         */
+        float update(float error, uint32_t now);
+        /**
+         * @brief whether enough cycles have been measured
+         */
+        bool done() const;
+        /**
+         * @brief what the test measured so far
+         */
+        RelayResult result() const;
+    private:
+        const float relay;
+        const float hysteresis;
+        const int cycles;
+        const int settleCycles;
+        bool started = false;
+        float sign = 1;
+        int rises = 0;
+        uint32_t lastRise = 0;
+        float high;
+        float low;
+        int measured = 0;
+        float periodSum = 0;
+        float amplitudeSum = 0;
+};
+
+/**
+ * @brief PID gains for a relay test result
+ *
+ * Gains are in the form lemlib::PID and ScheduledPID use, which sum the error and take its difference once per update
+ * rather than per second
+ *
+ * @param result what the relay test measured
+ * @param rule which tuning rule to use
+ * @param period seconds between controller updates, 0.01 for every motion on this robot
+ * @return Gains all zero if the result is not valid
+ */
+Gains relayGains(const RelayResult& result, TuningRule rule, float period);
+} // namespace kachow
@@ -0,0 +1,117 @@
+#pragma once
+
+namespace kachow {
+
+/**
+ * @brief Thresholds for SlipDetector
+ */
+struct SlipSettings {
+        /** how much faster the drive wheels may go than the ground before it counts as slip, in in/s. 6 */
+        float slipSpeed = 6;
+        /** how much faster the drive wheels may turn the robot than the IMU says it turned, in deg/s. 30 */
+        float turnSlipRate = 30;
+        /** drive wheels always scrub a little in turns, so this fraction of the turn rate is allowed on top. 0.25 */
+        float scrubAllowance = 0.25;
+        /** sideways speed the tracking wheel may see before the robot counts as being pushed, in in/s. 4 */
+        float slideSpeed = 4;
+        /** how quickly the ground speed estimate follows the wheels while they grip, in seconds. 0.15 */
+        float blendTime = 0.15;
+        /** wheel speed below which the robot counts as still, for measuring the accelerometer bias, in in/s. 0.5 */
+        float stillSpeed = 0.5;
+        /**
+         * after slipping this long the accelerometer has drifted too far to tell, so the wheels are trusted again, in
+         * seconds. 3
+         */
+        float maxSlipTime = 3;
+};
+
+/**
+ * @brief One 10ms worth of traction sensor readings
+ */
+struct TractionSample {
+        /** left drive wheel speed from the motor encoders, in in/s */
+        float leftVelocity;
+        /** right drive wheel speed from the motor encoders, in in/s */
+        float rightVelocity;
+        /** forward acceleration from the IMU, in in/s² */
+        float forwardAccel;
+        /** turn rate from the IMU, in rad/s, clockwise positive */
+        float turnRate;
+        /** horizontal tracking wheel speed, in in/s, left positive like LemLib. 0 if there is no tracking wheel */
+        float lateralVelocity;
+        /** seconds since the last sample */
+        float dt;
+};
+
+/**
+ * @brief what SlipDetector thinks the drive wheels are doing
+ */
+struct SlipState {
+        /** the drive wheels are going faster (or slower, when braking) than the robot */
+        bool slipping;
+        /** the drive wheels are turning the robot more than it is turning */
+        bool turnSlipping;
+        /** the robot is moving sideways, usually because something is pushing it */
+        bool sliding;
+        /** how much faster the drive wheels are going than the ground, in in/s. Only meaningful while slipping */
+        float forwardError;
+        /** best guess of the robot's forward speed over the ground, in in/s */
+        float groundVelocity;
+        /** how bad the slip is, 0 to 1 */
+        float severity;
+};
+
+/**
+ * @brief Detects drive wheel slip by comparing the drive encoders against the IMU and the tracking wheel
+ *
+ * The robot's speed over the ground is tracked by integrating the IMU's forward acceleration, and pulled towards the
+ * drive wheel speed while the two agree so the accelerometer's drift never builds up. When the wheels launch or brake
+ * harder than they can grip, or keep spinning while another robot holds ours in place, the wheel speed runs away from
+ * the ground speed and the wheels count as slipping until the two agree again. Turning slip is the drive wheels
+ * turning the robot faster than the IMU says it turned, and sliding is the horizontal tracking wheel seeing sideways
+ * motion that the turn does not explain.
+ *
+ * The accelerometer's bias is measured whenever the wheels are still, which also takes out the tilt of the IMU.
+ *
+ * Pure math with no PROS calls, so it can be checked on a computer. TractionMonitor runs it on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::SlipDetector detector(11.375, -1.5);
+ * const kachow::SlipState& state = detector.update({leftVelocity, rightVelocity, accel, turnRate, lateral, 0.01});
+ * if (state.slipping) chassis.setAccelerationCap(4);
+ * @endcode
+ */
+class SlipDetector {
+    public:
+        /**
+         * @brief Construct a new Slip Detector
+         *
+         * @param trackWidth distance between the left and right drive wheels, in inches
+         * @param trackingOffset how far forwards of the tracking center the horizontal tracking wheel is, in inches.
+         * Same as lemlib::TrackingWheel's offset
+         * @param settings struct to simulate named parameters
+         */
+        SlipDetector(float trackWidth, float trackingOffset, SlipSettings settings = {});
+        /**
+         * @brief Forget everything, e.g. after the robot was picked up
+         */
+        void reset();
+        /**
+         * @brief Take one sample
+         *
+         * @return the new state
+         */
+        const SlipState& update(const TractionSample& sample);
+        const SlipState& getState() const;
+        /** accelerometer bias measured while still, in in/s² */
+        float getAccelBias() const;
+    private:
+        float trackWidth;
+        float trackingOffset;
+        SlipSettings settings;
+        SlipState state {false, false, false, 0, 0, 0};
+        float accelBias = 0;
+        float slipTime = 0;
+};
+} // namespace kachow
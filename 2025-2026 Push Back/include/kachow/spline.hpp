@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+
+namespace kachow {
+
+/**
+ * @brief position, first and second derivative of a spline at one end of a segment
+ *
+ * Derivatives are with respect to the segment parameter t, not time or distance
+ */
+struct SplineKnot {
+        float x;
+        float y;
+        float dx;
+        float dy;
+        float ddx = 0;
+        float ddy = 0;
+};
+
+/**
+ * @brief one segment of a 2D spline, as quintic polynomials x(t) and y(t) for t from 0 to 1
+ *
+ * Quintic Hermite and cubic Bézier segments are both stored in this form, so everything that evaluates a path only has
+ * to deal with one kind of segment. Angles are in radians, standard position, like PathPoint.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // leave the origin facing +y and arrive at (24, 48) facing +x
+ * kachow::SplineSegment segment = kachow::SplineSegment::hermite({0, 0, 0, 60}, {24, 48, 60, 0});
+ * float x, y;
+ * segment.position(0.5, x, y);
+ * @endcode
+ */
+struct SplineSegment {
+        /** coefficients of x(t), lowest order first */
+        std::array<float, 6> cx {};
+        /** coefficients of y(t), lowest order first */
+        std::array<float, 6> cy {};
+
+        /**
+         * @brief Quintic Hermite segment matching position, first and second derivative at both ends
+         */
+        static SplineSegment hermite(const SplineKnot& start, const SplineKnot& end);
+        /**
+         * @brief Cubic Bézier segment through p0 and p3 with control points p1 and p2
+         */
+        static SplineSegment bezier(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3);
+
+        void position(float t, float& x, float& y) const;
+        void derivative(float t, float& dx, float& dy) const;
+        void secondDerivative(float t, float& ddx, float& ddy) const;
+        /**
+         * @brief direction of travel at t
+         */
+        float heading(float t) const;
+        /**
+         * @brief signed curvature at t in 1/in, positive when the segment turns left
+         */
+        float curvature(float t) const;
+};
+} // namespace kachow
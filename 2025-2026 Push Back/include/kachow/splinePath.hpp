@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kachow/path.hpp"
+#include "kachow/spline.hpp"
+
+namespace kachow {
+
+/** how many speeds are stored for each segment, evenly spaced by distance from its start to its end */
+constexpr size_t SPLINE_VELOCITY_SAMPLES = 8;
+
+/**
+ * @brief one segment of a spline path asset
+ */
+struct SplineRecord {
+        SplineSegment segment;
+        /** target speed, 0-127 like LemLib's text paths */
+        float velocity[SPLINE_VELOCITY_SAMPLES];
+};
+
+/** "KSPL" read as a little endian uint32 */
+constexpr uint32_t SPLINE_PATH_MAGIC = 0x4c50534b;
+constexpr uint16_t SPLINE_PATH_VERSION = 1;
+
+static_assert(sizeof(SplineRecord) == 80,
+              "spline path layout changed, bump SPLINE_PATH_VERSION and rebuild the assets");
+
+/**
+ * @brief A path stored as spline segments instead of points, evaluated wherever it is needed
+ *
+ * A spline path asset is a PathHeader with SPLINE_PATH_MAGIC and `count` segments, followed by `count`
+ * SplineRecords. tools/splinegen.cpp writes one when its output ends in .kspl. One segment takes 80 bytes where the
+ * same stretch of a point path takes 24 bytes per inch, and position, heading and curvature come from the polynomials
+ * so there is no resolution limit.
+ *
+ * Splines are parameterized by t, not distance, so the constructor caches the arc length at a few values of t on each
+ * segment. Looking up a distance is then a binary search, an interpolation and one Newton step. That cache is the only
+ * thing allocated; the segments are read straight out of the asset.
+ *
+ * @b Example
+ * @code {.cpp}
+ * ASSET(rushMiddle_kspl);
+ * kachow::SplinePath path(rushMiddle_kspl);
+ * chassis.follow(path, 15, 3000);
+ * @endcode
+ */
+class SplinePath {
+    public:
+        /**
+         * @brief Construct a path over an asset. The path is invalid if the asset is not a spline path
+         */
+        explicit SplinePath(const asset& file);
+        /**
+         * @brief Construct a path over a buffer holding a spline path
+         */
+        SplinePath(const uint8_t* buffer, size_t size);
+        /**
+         * @brief whether the buffer held a spline path of a version this code understands
+         */
+        bool isValid() const;
+        /**
+         * @brief number of segments. 0 if the path is invalid
+         */
+        size_t size() const;
+        /**
+         * @brief total length of the path in inches
+         */
+        float length() const;
+        /**
+         * @brief Get a segment. The index must be less than size()
+         */
+        SplineRecord operator[](size_t index) const;
+        /**
+         * @brief Evaluate the path a distance along it
+         *
+         * @param distance inches from the start, clamped to the path
+         * @return PathPoint with every field filled in, just like a point from a binary path
+         */
+        PathPoint at(float distance) const;
+        /**
+         * @brief index of the segment a distance along the path is on
+         */
+        size_t segmentAt(float distance) const;
+    private:
+        /** arc length cached at this many evenly spaced values of t on each segment, after the start */
+        static constexpr size_t ARC_LENGTH_STEPS = 16;
+
+        float parameter(size_t segment, float distance) const;
+
+        const uint8_t* records = nullptr;
+        size_t count = 0;
+        float pathLength = 0;
+        /** distance from the start of the path to the start of each segment, then the total length */
+        std::vector<float> segmentStart;
+        /** for each segment, distance from its start at t = 1/ARC_LENGTH_STEPS, 2/ARC_LENGTH_STEPS ... 1 */
+        std::vector<float> arcLengths;
+};
+
+/**
+ * @brief arc length of a segment between two values of t
+ */
+float arcLength(const SplineSegment& segment, float from, float to);
+} // namespace kachow
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kachow {
+
+/**
+ * @brief Runs the start-up work in parallel, and says when it is all done
+ *
+ * Each step runs in its own task as soon as the steps it waits on are done, so slow steps like IMU calibration
+ * overlap with everything that does not need them instead of holding it all up. Once every step is done the robot
+ * counts as ready, and the time that took and how long each step ran are logged.
+ *
+ * Add every step before calling start().
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::StartupSequencer startup;
+ *
+ * void initialize() {
+ *     const int config = startup.add("config", loadConfig);
+ *     const int imu = startup.add("IMU", [] { imu.reset(true); });
+ *     startup.add("odometry", [] { chassis.calibrate(false); }, {config, imu});
+ *     startup.start();
+ * }
+ *
+ * void autonomous() {
+ *     startup.waitUntilReady(); // don't move until the sensors are up
+ * }
+ * @endcode
+ */
+class StartupSequencer {
+    public:
+        /**
+         * @brief Add a step
+         *
+         * @param name what to call the step on the screen and in the log
+         * @param step the work to do
+         * @param after steps, by the index add returned for them, that have to finish before this one starts
+         * @return int the step's index
+         */
+        int add(const std::string& name, std::function<void()> step, std::vector<int> after = {});
+        /**
+         * @brief Start every step. Returns straight away
+         */
+        void start();
+        /**
+         * @brief Whether every step has finished
+         */
+        bool isReady() const;
+        /**
+         * @brief Wait for every step to finish
+         *
+         * @param timeout longest to wait, in ms. Forever by default
+         * @return true if ready, false if it timed out
+         */
+        bool waitUntilReady(int timeout = -1) const;
+        /**
+         * @brief How many steps have finished
+         */
+        int finished() const;
+        /**
+         * @brief How many steps there are
+         */
+        int count() const;
+        /**
+         * @brief The name of a step that is still going, the first one added if there are several. Empty if ready
+         */
+        std::string running() const;
+        /**
+         * @brief Time from start() to ready, in ms. 0 until ready
+         */
+        uint32_t getReadyTime() const;
+    private:
+        struct Step {
+                std::string name;
+                std::function<void()> run;
+                std::vector<int> after;
+                std::atomic<bool> done = false;
+                uint32_t duration = 0;
+        };
+
+        void logTimes() const;
+
+        // by pointer, since a step's atomic can't be moved when the vector grows
+        std::vector<std::unique_ptr<Step>> steps;
+        std::atomic<int> done = 0;
+        uint32_t startTime = 0;
+        std::atomic<uint32_t> readyTime = 0;
+        bool started = false;
+};
+} // namespace kachow
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+namespace kachow {
+
+/**
+ * @brief a first order plus dead time model of how something responds to a step in its command
+ */
+struct StepResponse {
+        /** false if the response never settled, or never moved */
+        bool valid;
+        /** time before the response starts to move, in seconds */
+        float deadTime;
+        /** time from then to get 63% of the way there, in seconds */
+        float timeConstant;
+        /** where the response settled, in the same units as the samples */
+        float finalValue;
+};
+
+/**
+ * @brief Fit a first order plus dead time model to a step response
+ *
+ * Uses the two point method: the times the response reaches 28% and 63% of the way to its final value give the time
+ * constant, and whatever delay is left over is dead time. The final value is the average of the last fifth of the
+ * samples, so record for long enough that the response has settled by then. Crossing times are interpolated between
+ * samples, so the dead time comes out finer than the sample period.
+ *
+ * @param samples the response, starting from rest, the first one taken at time
+ * @param dt seconds between samples
+ * @param time seconds after the step that the first sample represents. 0 by default
+ * @return StepResponse check valid before using it
+ *
+ * @b Example
+ * @code {.cpp}
+ * // drive velocity sampled every 10ms after stepping the motors from 0 to 60
+ * kachow::StepResponse response = kachow::fitStepResponse(velocities, 0.01);
+ * if (response.valid) chassis.setLatency(response.deadTime * 1000);
+ * @endcode
+ */
+StepResponse fitStepResponse(const std::vector<float>& samples, float dt, float time = 0);
+} // namespace kachow
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pros/motor_group.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/thermalModel.hpp"
+
+namespace kachow {
+
+/**
+ * @brief How close a group of motors is to throttling itself, going by its worst motor
+ */
+struct ThermalHeadroom {
+        /** hottest estimated temperature, in °C */
+        float temperature = NAN;
+        /** how far that is below the limit, in °C */
+        float headroom = NAN;
+        /** soonest any motor is predicted to hit the limit, in seconds. Infinite if none will at this load */
+        float timeToLimit = INFINITY;
+        /** share of the full current limit the group is allowed */
+        float derate = 1;
+};
+
+/**
+ * @brief Eases motors off before they hit the V5 thermal limit, instead of letting them throttle abruptly
+ *
+ * Every 20ms, runs a ThermalModel on each motor from its current draw, temperature and duty cycle. Each group of
+ * motors is derated together by its worst motor, so both sides of the drive always stay matched:
+ * - the current limit is lowered smoothly from the full limit down to minDerate of it
+ * - for the drive, the chassis' lateral acceleration is capped as well, from no cap down to minSlew
+ * - derating starting and stopping is logged, and the headroom left goes to telemetry every 5 seconds
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::ThermalGuard thermals(&chassis, &leftMotors, &rightMotors);
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     thermals.add("intake", &intakeMotors);
+ *     thermals.start();
+ * }
+ * @endcode
+ */
+class ThermalGuard {
+    public:
+        /**
+         * @brief Construct a new Thermal Guard
+         *
+         * @param chassis the chassis driven by these motors
+         * @param left the left drive motors
+         * @param right the right drive motors
+         * @param settings struct to simulate named parameters
+         * @param minSlew the drive's lateral acceleration cap at minDerate, per 10ms out of 127. 3
+         */
+        ThermalGuard(Chassis* chassis, pros::MotorGroup* left, pros::MotorGroup* right, ThermalSettings settings = {},
+                     float minSlew = 3);
+        /**
+         * @brief Guard another group of motors. Only its current limit is derated
+         *
+         * Safe to call from any task, before or after start()
+         */
+        void add(const std::string& name, pros::MotorGroup* motors);
+        /**
+         * @brief Start watching. Call after chassis.calibrate()
+         */
+        void start();
+        /**
+         * @brief Headroom of a group added with add(), or "drive" for the drive
+         */
+        ThermalHeadroom getHeadroom(const std::string& name) const;
+        /**
+         * @brief Log the hottest each group has been, e.g. between matches
+         */
+        void logReport() const;
+    private:
+        struct Guarded {
+                std::string name;
+                std::vector<pros::MotorGroup*> groups;
+                std::vector<ThermalModel> models;
+                ThermalHeadroom headroom;
+                float hottest = NAN;
+                // in mA
+                std::int32_t fullLimit = 0;
+                std::int32_t limit = 0;
+        };
+
+        void add(const std::string& name, const std::vector<pros::MotorGroup*>& groups);
+        // models and current limits, once the motors are up
+        void setUp(Guarded& group);
+        void update(float dt);
+        void limitCurrent(Guarded& group);
+
+        Chassis* chassis;
+        ThermalSettings settings;
+        float minSlew;
+        // the drive is always first
+        std::vector<Guarded> guarded;
+        float thermalCap = 0;
+        uint32_t lastTelemetry = 0;
+        // guards the list of groups and everything in it, held for the whole of every update
+        mutable pros::Mutex mutex;
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
@@ -0,0 +1,96 @@
+#pragma once
+
+namespace kachow {
+
+/**
+ * @brief Thermal constants for ThermalModel. The defaults are for a V5 motor
+ *
+ * The heating and cooling rates are rough guesses, not fitted to a real motor. Log a hard run's current, duty cycle
+ * and temperature and fit them before trusting the time to the limit.
+ */
+struct ThermalSettings {
+        /** temperature the motor starts limiting its own current at, in °C. 55 */
+        float limit = 55;
+        /** temperature the motor cools towards, in °C. 25 */
+        float ambient = 25;
+        /** how fast current heats the motor, in °C/s per A². 0.05 */
+        float currentHeating = 0.05;
+        /** how fast the motor's electronics heat it at full duty cycle, in °C/s. 0.02 */
+        float dutyHeating = 0.02;
+        /** how fast the motor cools towards ambient, per second. 0.003 */
+        float cooling = 0.003;
+        /** how fast the estimate is pulled towards the motor's own temperature reading, per second. 0.05 */
+        float correction = 0.05;
+        /** step size of the motor's temperature reading, in °C. The motor is somewhere in the step above it. 5 */
+        float resolution = 5;
+        /** how long the load is averaged over to predict when the limit is hit, in seconds. 10 */
+        float loadTime = 10;
+        /** derating starts once the limit is predicted within this long, in seconds. 30 */
+        float warnTime = 30;
+        /** the least the motor is derated to, as a share of its full current. 0.5 */
+        float minDerate = 0.5;
+};
+
+/**
+ * @brief Predicts when a motor will overheat, so it can be eased off before it throttles itself
+ *
+ * V5 motors cut their own current limit hard once they reach the limit temperature, which loses pushing battles
+ * without warning. This estimates the motor's temperature with a first order model, heated by its current and duty
+ * cycle and cooled towards ambient. The motor's own reading only comes in steps of 5°C, so the estimate is only pulled
+ * back when it leaves the step the reading says the motor is in. From the load averaged over the last loadTime it
+ * predicts how long the motor has before it hits the limit. The derate then falls smoothly from 1 to minDerate as that
+ * time goes from warnTime to 0, so whatever uses it can ease off the current and acceleration well before the motor
+ * does it abruptly.
+ *
+ * Pure math with no PROS calls. ThermalGuard runs it on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::ThermalModel model;
+ * model.update(2.1, 0.9, 45, 0.02);
+ * if (model.getTimeToLimit() < 10) printf("%.0fs left\n", model.getTimeToLimit());
+ * @endcode
+ */
+class ThermalModel {
+    public:
+        /**
+         * @brief Construct a new Thermal Model
+         *
+         * @param settings struct to simulate named parameters
+         */
+        explicit ThermalModel(ThermalSettings settings = {});
+        /**
+         * @brief Add a sample
+         *
+         * @param current current draw, in A
+         * @param duty share of full voltage applied, 0 to 1
+         * @param measured the motor's temperature reading, in °C. NaN if it could not be read
+         * @param dt seconds since the last sample
+         */
+        void update(float current, float duty, float measured, float dt);
+        /**
+         * @brief Estimated temperature, in °C
+         */
+        float getTemperature() const;
+        /**
+         * @brief How far below the limit the motor is, in °C
+         */
+        float getHeadroom() const;
+        /**
+         * @brief Predicted time until the motor hits the limit at the recent load, in seconds
+         *
+         * Infinite if it never will at that load
+         */
+        float getTimeToLimit() const;
+        /**
+         * @brief Share of full current and acceleration to allow, from minDerate to 1
+         */
+        float getDerate() const;
+    private:
+        ThermalSettings settings;
+        float temperature;
+        // heating rate averaged over loadTime, in °C/s
+        float load = 0;
+        bool started = false;
+};
+} // namespace kachow
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "pros/imu.hpp"
+#include "pros/rtos.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/slipDetector.hpp"
+
+namespace kachow {
+
+/**
+ * @brief which of the IMU's accelerometer axes points towards the front of the robot
+ */
+enum class ImuAxis {
+    X, /** the IMU's x axis points forwards */
+    Y, /** the IMU's y axis points forwards */
+    NEGATIVE_X, /** the IMU's x axis points backwards */
+    NEGATIVE_Y /** the IMU's y axis points backwards */
+};
+
+/**
+ * @brief whether the accelerometer axis TractionMonitor was given really points forwards
+ */
+enum class AxisCheck {
+    UNCHECKED, /** the robot has not sped up or slowed down enough yet to tell */
+    CONFIRMED, /** the accelerometer speeds up when the drive wheels do */
+    WRONG /** the accelerometer speeds up when the drive wheels slow down, or the other way round */
+};
+
+/**
+ * @brief what TractionMonitor has seen so far
+ */
+struct TractionStats {
+        /** how many times the drive wheels started slipping */
+        uint32_t slipEvents;
+        /** total time spent slipping, in ms */
+        uint32_t slipTime;
+        /** total time spent being pushed sideways, in ms */
+        uint32_t slideTime;
+        /** total distance taken back out of odometry because the wheels were slipping, in inches */
+        float removedDistance;
+};
+
+/**
+ * @brief Watches the drive wheels for slip and stops it from ruining the pose
+ *
+ * Runs a SlipDetector every 10ms on the drive motors' velocities, the IMU and the horizontal tracking wheel. While the
+ * drive wheels slip:
+ * - LemLib's odometry, which counts drive wheel turns, is moved back by however far the wheels turned past the
+ *   ground, so only the distance the IMU agrees with is kept
+ * - every lateral motion has its acceleration capped, so the wheels get a chance to grip again instead of spinning
+ *   harder
+ * - a FusedOdometry given this monitor trusts the drive encoders less
+ *
+ * Taking slipped distance out of odometry is off until setCorrectOdometry turns it on, and even then waits for the
+ * axis check: while the wheels grip, the accelerometer's forward axis has to speed up and slow down with the drive
+ * wheels. A wrong axis would see slip on every start and stop and move the pose the wrong way, so until the check has
+ * confirmed the axis, slip only caps acceleration.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::TractionMonitor traction(&chassis, &horizontal, &imu);
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     traction.start();
+ * }
+ * @endcode
+ */
+class TractionMonitor {
+    public:
+        /**
+         * @brief Construct a new Traction Monitor
+         *
+         * @param chassis the chassis whose odometry and motions to protect. Its drivetrain gives the drive motors,
+         * wheel size and track width
+         * @param horizontal the horizontal tracking wheel, or nullptr if there is none
+         * @param imu the IMU LemLib uses
+         * @param forward which accelerometer axis points forwards. ImuAxis::Y by default
+         * @param settings struct to simulate named parameters
+         */
+        TractionMonitor(Chassis* chassis, lemlib::TrackingWheel* horizontal, pros::Imu* imu,
+                        ImuAxis forward = ImuAxis::Y, SlipSettings settings = {});
+        /**
+         * @brief Start watching. Call after chassis.calibrate()
+         */
+        void start();
+        /**
+         * @brief Acceleration cap applied to lateral motions while slipping
+         *
+         * @param slew largest increase in lateral output per 10ms, out of 127. 0 never caps. 4 by default
+         */
+        void setAccelerationCap(float slew);
+        /**
+         * @brief Whether to take slipped distance back out of LemLib's odometry. Off by default
+         *
+         * Only takes effect once getAxisCheck has confirmed the forward axis
+         */
+        void setCorrectOdometry(bool correct);
+        /**
+         * @brief Whether driving so far agrees with the forward axis the monitor was given
+         */
+        AxisCheck getAxisCheck() const;
+        SlipState getState() const;
+        TractionStats getStats() const;
+    private:
+        void update(float dt);
+
+        Chassis* chassis;
+        lemlib::TrackingWheel* horizontal;
+        pros::Imu* imu;
+        ImuAxis forward;
+        SlipSettings settings;
+        SlipDetector detector;
+        // from the chassis's drivetrain, in start()
+        pros::MotorGroup* leftMotors = nullptr;
+        pros::MotorGroup* rightMotors = nullptr;
+        // motor rpm to wheel in/s, worked out from the cartridge once the motors are up
+        float velocityScale = 0;
+        float prevLateral = 0;
+        float prevRotation = 0;
+        // in/s, average of the two sides
+        float prevSpeed = 0;
+        // gripping steps where the accelerometer and the drive wheels sped up the same way, and the other way
+        uint32_t axisAgrees = 0;
+        uint32_t axisDisagrees = 0;
+        std::atomic<AxisCheck> axisCheck = AxisCheck::UNCHECKED;
+        // false after a step the sensors could not be read
+        bool synced = false;
+        float accelerationCap = 4;
+        bool correctOdometry = false;
+        bool capped = false;
+        TractionStats stats {0, 0, 0, 0};
+        pros::Task* task = nullptr;
+};
+} // namespace kachow
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include "kachow/spline.hpp"
+#include "kachow/splinePath.hpp"
+
+namespace kachow {
+
+/**
+ * @brief where the robot should be, and how fast it should be going, at one moment of a trajectory
+ *
+ * Angles are in radians, standard position, like PathPoint
+ */
+struct TrajectoryState {
+        /** seconds from the start of the trajectory */
+        float time;
+        float x;
+        float y;
+        float theta;
+        /** in/s */
+        float velocity;
+        /** rad/s, positive turns left */
+        float angularVelocity;
+};
+
+/** how long a tracker keeps correcting after the trajectory ends if the robot has not caught up, in seconds */
+constexpr float TRAJECTORY_SETTLE_TIME = 0.5;
+/** how close to the end of the trajectory counts as caught up, in inches */
+constexpr float TRAJECTORY_END_TOLERANCE = 1;
+/** how slow the robot must be going to count as stopped at the end of the trajectory, in in/s */
+constexpr float TRAJECTORY_END_SPEED = 2;
+
+/**
+ * @brief limits used when timing a trajectory
+ */
+struct TrajectoryConstraints {
+        /**
+         * top speed in in/s. Also caps the outside wheel in turns. Leave some headroom below the drivetrain's real top
+         * speed so the tracker has room to catch up when the robot falls behind
+         */
+        float maxSpeed;
+        /** in/s², for both speeding up and slowing down */
+        float maxAccel;
+        /** in inches */
+        float trackWidth;
+        /** sideways acceleration in turns in in/s². 0 for no limit */
+        float maxLateral = 0;
+};
+
+/**
+ * @brief A path with a schedule: where the robot should be at every moment, not just where it should go
+ *
+ * Built once before the motion starts, at roughly one state per inch. Between states, sample() interpolates, so it can
+ * be read at whatever time the control loop gets to.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // leave the origin facing +y, arrive at (24, 48) facing +x
+ * kachow::Trajectory trajectory = kachow::Trajectory::generate(
+ *     {kachow::SplineSegment::hermite({0, 0, 0, 60}, {24, 48, 60, 0})}, {60, 100, 11.375});
+ * chassis.followTrajectory(trajectory, 3000);
+ * @endcode
+ */
+class Trajectory {
+    public:
+        Trajectory() = default;
+        /**
+         * @brief Construct a trajectory from states, which must be in time order
+         */
+        explicit Trajectory(std::vector<TrajectoryState> states);
+        /**
+         * @brief Time a spline path using the speeds stored in it
+         *
+         * @param path the path to follow. Must be valid
+         * @param maxSpeed speed in in/s that a stored speed of 127 means. As with TrajectoryConstraints::maxSpeed, keep
+         * it below the drivetrain's real top speed
+         * @param spacing inches between states
+         */
+        static Trajectory fromPath(const SplinePath& path, float maxSpeed, float spacing = 1);
+        /**
+         * @brief Time spline segments with the fastest speeds the constraints allow, starting and ending at rest
+         *
+         * @param segments segments in order, each starting where the last one ended
+         * @param constraints speed and acceleration limits
+         * @param spacing inches between states
+         */
+        static Trajectory generate(const std::vector<SplineSegment>& segments, const TrajectoryConstraints& constraints,
+                                   float spacing = 1);
+        /**
+         * @brief Get the state at a time, clamped to the start and end of the trajectory
+         *
+         * @param time seconds from the start
+         * @param lead seconds further on to read the speeds at. A drive that takes about this long to reach a new
+         * speed then gets there when the trajectory does, rather than that much behind it. 0 by default
+         */
+        TrajectoryState sample(float time, float lead = 0) const;
+        /**
+         * @brief how long the trajectory takes, in seconds
+         */
+        float duration() const;
+        bool empty() const;
+        const std::vector<TrajectoryState>& getStates() const;
+    private:
+        std::vector<TrajectoryState> states;
+};
+
+/**
+ * @brief what the trajectory tracker wants the drivetrain to do
+ */
+struct TrackerOutput {
+        /** in/s */
+        float velocity;
+        /** rad/s, positive turns left */
+        float angularVelocity;
+};
+
+/**
+ * @brief RAMSETE unicycle tracking controller
+ *
+ * Drives at the trajectory's own speed and turn rate, and corrects for the difference between where the robot is and
+ * where the trajectory says it should be with a nonlinear feedback law that converges for any starting error. Because
+ * the schedule comes from the trajectory, the robot gets to each point at a predictable time.
+ *
+ * The usual defaults of b = 2 and zeta = 0.7 are in metres; b scales with 1/length², so in inches it is 2 * 0.0254².
+ * The textbook law's correction gain falls to 0 when the trajectory is at rest, which leaves a robot that fell behind
+ * stuck short of the end, so the gain has a floor.
+ */
+class Ramsete {
+    public:
+        /**
+         * @brief Construct a new Ramsete controller
+         *
+         * @param b how hard to correct position errors, in rad²/in². Larger is more aggressive
+         * @param zeta damping, between 0 and 1. Larger damps more
+         * @param minGain smallest correction gain in 1/s, used when the trajectory is slow or stopped
+         */
+        Ramsete(float b = 2 * 0.0254f * 0.0254f, float zeta = 0.7f, float minGain = 2);
+        /**
+         * @brief Run one iteration
+         *
+         * @param x robot x, in inches
+         * @param y robot y, in inches
+         * @param theta robot heading, radians in standard position
+         * @param goal where the robot should be right now
+         * @return TrackerOutput
+         */
+        TrackerOutput calculate(float x, float y, float theta, const TrajectoryState& goal) const;
+    private:
+        const float b;
+        const float zeta;
+        const float minGain;
+};
+} // namespace kachow
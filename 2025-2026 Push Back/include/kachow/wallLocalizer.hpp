@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace kachow {
+
+/**
+ * @brief a straight wall or side of a field element that a distance sensor can see, in field inches
+ */
+struct FieldSegment {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+};
+
+/**
+ * @brief where a ray from a distance sensor hits the field
+ */
+struct RayHit {
+        /** inches along the ray. INFINITY if nothing was hit */
+        float distance;
+        /** unit normal of the surface that was hit, pointing back towards the sensor */
+        float normalX;
+        float normalY;
+};
+
+/**
+ * @brief The walls the distance sensors can see
+ *
+ * Starts as the field perimeter. Add field elements the sensors are mounted low enough to see; anything a sensor might
+ * see that is not in the map (robots, game elements) is rejected by the localizer as an outlier.
+ *
+ * @b Example
+ * @code {.cpp}
+ * kachow::FieldMap map;
+ * // a 4in wide barrier along x = 72
+ * map.addBox(70, 48, 74, 96);
+ * @endcode
+ */
+class FieldMap {
+    public:
+        /**
+         * @brief Construct a field map with only the perimeter
+         *
+         * @param size side length of the square field, in inches. 144 by default
+         */
+        explicit FieldMap(float size = 144);
+        /**
+         * @brief Add a wall
+         */
+        void addSegment(FieldSegment segment);
+        /**
+         * @brief Add the four sides of an axis-aligned rectangle, given by two opposite corners
+         */
+        void addBox(float x1, float y1, float x2, float y2);
+        /**
+         * @brief Find the first wall along a ray
+         *
+         * @param x start of the ray
+         * @param y start of the ray
+         * @param heading direction of the ray, compass degrees
+         * @return RayHit distance INFINITY if the ray hits nothing
+         */
+        RayHit raycast(float x, float y, float heading) const;
+        const std::vector<FieldSegment>& getSegments() const;
+    private:
+        std::vector<FieldSegment> segments;
+};
+
+/**
+ * @brief where a distance sensor is on the robot
+ *
+ * Offsets use the same frame as lemlib::TrackingWheel: x is to the right of the tracking center and y is forwards
+ */
+struct SensorMount {
+        /** inches to the right of the tracking center */
+        float x;
+        /** inches forwards of the tracking center */
+        float y;
+        /** which way the sensor points relative to the front of the robot, degrees clockwise. 90 points right */
+        float heading;
+};
+
+/**
+ * @brief one distance sensor reading, in the form pros::Distance reports it except for the distance
+ */
+struct DistanceReading {
+        /** inches */
+        float distance;
+        /** 0 to 63, how sure the sensor is of the distance */
+        int confidence;
+        /** 0 to 400, roughly how big the object is. Walls read large */
+        int objectSize;
+};
+
+/**
+ * @brief Parameters for WallLocalizer
+ */
+struct LocalizerSettings {
+        /** readings below this confidence are ignored. Only checked past 200mm, where the sensor reports one. 40 */
+        int minConfidence = 40;
+        /** readings of smaller objects than this are ignored, since they are more likely game elements. 100 */
+        int minObjectSize = 100;
+        /** readings further than this are ignored, in inches. The sensor gets noisy past 2m. 78 */
+        float maxDistance = 78;
+        /** readings that disagree with the expected distance by more than this are ignored, in inches. 4 */
+        float maxResidual = 4;
+        /** rays that hit a wall further than this from square are ignored, in degrees. 40 */
+        float maxIncidence = 40;
+        /** readings are a few tens of ms old, so ignore them while moving towards or away from the wall faster than
+         * this, in in/s. 20 */
+        float maxSpeed = 20;
+        /** fraction of the error to correct each update, so single readings only nudge the pose. 0.2 */
+        float gain = 0.2;
+};
+
+/**
+ * @brief how far to move the pose to agree with the distance sensors
+ */
+struct Correction {
+        float x;
+        float y;
+        /** how many sensors contributed */
+        int sensors;
+};
+
+/**
+ * @brief Corrects odometry drift with distance sensors pointed at the field walls
+ *
+ * For each sensor, the wall it should be looking at is found by casting a ray from where odometry says the sensor is.
+ * The difference between the expected and measured distance moves the pose along that wall's normal, so a sensor
+ * looking at a wall only ever corrects the axis it can actually see. Readings the sensor is unsure of, that look like
+ * a small object, that hit a wall at a glancing angle or that disagree too much with odometry are skipped. Heading is
+ * never changed; the IMU is much better at that than two distance sensors would be.
+ *
+ * Pure math with no PROS calls, so it can be checked on a computer. DistanceLocalization runs it on the robot.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // one sensor on the left side, one on the back
+ * kachow::WallLocalizer localizer(kachow::FieldMap(), {{-6, 0, -90}, {0, -7, 180}});
+ * kachow::Correction correction = localizer.correct(pose.x, pose.y, pose.theta, 0, 0, readings);
+ * chassis.setPose(pose.x + correction.x, pose.y + correction.y, pose.theta);
+ * @endcode
+ */
+class WallLocalizer {
+    public:
+        /**
+         * @brief Construct a new Wall Localizer
+         *
+         * @param map the walls the sensors can see
+         * @param mounts where each sensor is, in the same order as the readings passed to correct
+         * @param settings struct to simulate named parameters
+         */
+        WallLocalizer(FieldMap map, std::vector<SensorMount> mounts, LocalizerSettings settings = {});
+        /**
+         * @brief Work out the correction for one set of readings
+         *
+         * @param x odometry x, inches
+         * @param y odometry y, inches
+         * @param theta odometry heading, compass degrees
+         * @param xVelocity field x velocity, in/s
+         * @param yVelocity field y velocity, in/s
+         * @param readings one per mount, in the same order
+         * @return Correction to add to the pose. Zero with no sensors contributing if no reading was good enough
+         */
+        Correction correct(float x, float y, float theta, float xVelocity, float yVelocity,
+                           const std::vector<DistanceReading>& readings) const;
+        /**
+         * @brief The distance a sensor should read from a pose
+         *
+         * @return RayHit distance INFINITY if the sensor would see nothing in the map
+         */
+        RayHit expected(size_t sensor, float x, float y, float theta) const;
+        size_t size() const;
+    private:
+        FieldMap map;
+        std::vector<SensorMount> mounts;
+        LocalizerSettings settings;
+};
+} // namespace kachow
@@ -0,0 +1,40 @@
+#include "kachow/autotune.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "pros/rtos.hpp"
+
+namespace kachow {
+
+RelayResult autotune(std::function<float()> measure, std::function<void(float)> actuate, float target,
+                     AutotuneSettings settings) {
+    RelayTuner tuner(settings.relay, settings.hysteresis, settings.cycles, settings.settleCycles);
+    const uint32_t start = pros::millis();
+    uint32_t now = start;
+    while (!tuner.done() && now - start < uint32_t(settings.timeout)) {
+        actuate(tuner.update(target - measure(), now));
+        pros::Task::delay_until(&now, 10);
+    }
+    actuate(0);
+
+    const RelayResult result = tuner.result();
+    if (result.valid) {
+        lemlib::infoSink()->info("autotune: ultimate gain {:.3f}, period {:.3f}s, amplitude {:.2f}",
+                                 result.ultimateGain, result.ultimatePeriod, result.amplitude);
+    } else {
+        lemlib::infoSink()->warn("autotune: no steady oscillation after {}ms, try a larger relay or less hysteresis",
+                                 pros::millis() - start);
+    }
+    return result;
+}
+
+void saveGains(Config& config, const std::string& prefix, const Gains& gains) {
+    config.set(prefix + ".kP", gains.kP);
+    config.set(prefix + ".kI", gains.kI);
+    config.set(prefix + ".kD", gains.kD);
+}
+
+bool loadGains(const Config& config, const std::string& prefix, Gains& gains) {
+    if (!config.has(prefix + ".kP") || !config.has(prefix + ".kI") || !config.has(prefix + ".kD")) return false;
+    gains = {config.getFloat(prefix + ".kP"), config.getFloat(prefix + ".kI"), config.getFloat(prefix + ".kD")};
+    return true;
+}
+} // namespace kachow
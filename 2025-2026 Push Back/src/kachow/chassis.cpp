@@ -0,0 +1,814 @@
+#include "kachow/chassis.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "kachow/purePursuit.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+
+namespace kachow {
+
+void Chassis::follow(PathView path, float lookahead, int timeout, bool forwards, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { follow(path, lookahead, timeout, forwards, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    if (!path.isValid()) {
+        lemlib::infoSink()->error("follow: asset is not a binary path, was it built from static/*.txt?");
+        this->endMotion();
+        return;
+    }
+
+    PurePursuit pursuit(path, lookahead);
+    followPursuit(pursuit, timeout, forwards);
+}
+
+void Chassis::follow(SplinePath path, float lookahead, int timeout, bool forwards, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { follow(path, lookahead, timeout, forwards, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    if (!path.isValid()) {
+        lemlib::infoSink()->error("follow: asset is not a spline path, was it written by splinegen as a .kspl?");
+        this->endMotion();
+        return;
+    }
+
+    SplinePursuit pursuit(path, lookahead);
+    followPursuit(pursuit, timeout, forwards);
+}
+
+ChainTarget ChainTarget::point(float x, float y, bool forwards, float maxSpeed) {
+    return {ChainTargetType::POINT, x, y, 0, forwards, maxSpeed};
+}
+
+ChainTarget ChainTarget::pose(float x, float y, float theta, bool forwards, float maxSpeed) {
+    return {ChainTargetType::POSE, x, y, theta, forwards, maxSpeed};
+}
+
+ChainTarget ChainTarget::heading(float theta, float maxSpeed) {
+    return {ChainTargetType::HEADING, 0, 0, theta, true, maxSpeed};
+}
+
+namespace {
+// how fast a drive with all its torque gets up to speed, as a lateral slew per 10ms out of 127. About a quarter second
+// from standing to full speed
+constexpr float FULL_TORQUE_SLEW = 5;
+
+// whether the robot can go from one target to the next without stopping
+bool drivesThrough(const ChainTarget& from, const ChainTarget& to) {
+    return from.type != ChainTargetType::HEADING && to.type != ChainTargetType::HEADING &&
+           from.forwards == to.forwards;
+}
+} // namespace
+
+void Chassis::chain(std::vector<ChainTarget> targets, int timeout, ChainParams params, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { chain(targets, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    if (targets.empty()) {
+        this->endMotion();
+        return;
+    }
+
+    // reset everything once for the whole chain
+    lateralPID.reset();
+    angularPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    lemlib::Pose lastPose = getPose(true);
+    // where the leg to the current target started, progress along it decides when a target has been passed
+    float fromX = lastPose.x;
+    float fromY = lastPose.y;
+    float prevLateral = 0;
+    float prevAngular = 0;
+    size_t index = 0;
+    distTraveled = 0;
+    const uint32_t start = pros::millis();
+    while (this->motionRunning && pros::millis() - start < uint32_t(stretchTimeout(timeout))) {
+        const lemlib::Pose measured = getPose(true);
+        distTraveled += measured.distance(lastPose);
+        lastPose = measured;
+        const lemlib::Pose pose = getControlPose(true);
+
+        const ChainTarget& target = targets[index];
+        const bool last = index + 1 == targets.size();
+        bool advance = false;
+        float lateralOut = 0;
+        float angularOut;
+
+        if (target.type == ChainTargetType::HEADING) {
+            // steer by the control pose, but only leave the target once the robot really points at it
+            angularOut = angularPID.update(lemlib::angleError(target.theta, lemlib::radToDeg(pose.theta), false));
+            const float error = lemlib::angleError(target.theta, lemlib::radToDeg(measured.theta), false);
+            if (last) {
+                angularSmallExit.update(error);
+                angularLargeExit.update(error);
+                if (angularSmallExit.getExit() || angularLargeExit.getExit()) break;
+            } else {
+                advance = std::fabs(error) < params.blendAngle;
+            }
+        } else {
+            const float direction = target.forwards ? 1 : -1;
+            // the way the robot is driving, which is its back when going backwards
+            const float driveTheta = target.forwards ? pose.theta : pose.theta + M_PI;
+            // progress, and with it settling, exiting and advancing, is measured where the robot is now
+            const float dist = std::hypot(target.x - measured.x, target.y - measured.y);
+            const float legLength = std::hypot(target.x - fromX, target.y - fromY);
+            const float along = legLength > 0 ? ((target.x - measured.x) * (target.x - fromX) +
+                                                 (target.y - measured.y) * (target.y - fromY)) /
+                                                    legLength
+                                              : dist;
+            // steering is worked out from where the robot will be when the output lands
+            const float controlDist = std::hypot(target.x - pose.x, target.y - pose.y);
+            const bool through = !last && drivesThrough(target, targets[index + 1]);
+
+            float aimX = target.x;
+            float aimY = target.y;
+            if (target.type == ChainTargetType::POSE) {
+                // boomerang carrot point behind the target, like moveToPose
+                const float theta = lemlib::degToRad(target.theta);
+                aimX -= direction * params.lead * controlDist * std::sin(theta);
+                aimY -= direction * params.lead * controlDist * std::cos(theta);
+            }
+            if (through && along < params.blendRadius) {
+                // slide the aim point over to the next target, reaching it as the robot passes this one
+                const ChainTarget& next = targets[index + 1];
+                const float blend = std::clamp(1 - along / params.blendRadius, 0.0f, 1.0f);
+                aimX += (next.x - aimX) * blend;
+                aimY += (next.y - aimY) * blend;
+            }
+
+            // distance to the next place the robot has to stop, so it keeps its speed through targets
+            const float targetAngle = std::atan2(target.x - pose.x, target.y - pose.y);
+            float remaining = controlDist * std::cos(lemlib::angleError(targetAngle, driveTheta));
+            for (size_t i = index; i + 1 < targets.size() && drivesThrough(targets[i], targets[i + 1]); i++) {
+                remaining += std::hypot(targets[i + 1].x - targets[i].x, targets[i + 1].y - targets[i].y);
+            }
+            lateralOut = direction * lateralPID.update(remaining);
+
+            // close to where the robot stops, steering at the target would spin it, so settle the heading of a pose
+            // or stop steering at a point. The PID still sees the real error so its derivative has nothing to kick at
+            // when the robot gets close, like LemLib's moveToPoint
+            const bool close = !through && dist < 7.5;
+            if (close && target.type == ChainTargetType::POSE) {
+                angularOut = angularPID.update(lemlib::angleError(target.theta, lemlib::radToDeg(pose.theta), false));
+            } else {
+                const float aimAngle = std::atan2(aimX - pose.x, aimY - pose.y);
+                angularOut = angularPID.update(lemlib::radToDeg(lemlib::angleError(aimAngle, driveTheta)));
+                if (close) angularOut = 0;
+            }
+
+            if (last) {
+                lateralSmallExit.update(dist);
+                lateralLargeExit.update(dist);
+                if (lateralSmallExit.getExit() || lateralLargeExit.getExit()) break;
+            } else {
+                advance = through ? along <= 0 : along < lateralSettings.smallError;
+            }
+        }
+
+        // limit speed, carrying on from the last output whatever target it was for
+        lateralOut = std::clamp(lateralOut, -target.maxSpeed, target.maxSpeed);
+        angularOut = std::clamp(angularOut, -target.maxSpeed, target.maxSpeed);
+        if (lateralSettings.slew > 0 && std::fabs(lateralOut) > std::fabs(prevLateral)) {
+            lateralOut = lemlib::slew(lateralOut, prevLateral, lateralSettings.slew);
+        }
+        if (angularSettings.slew > 0 && std::fabs(angularOut) > std::fabs(prevAngular)) {
+            angularOut = lemlib::slew(angularOut, prevAngular, angularSettings.slew);
+        }
+        // turning takes priority over driving
+        const float overturn = std::fabs(angularOut) + std::fabs(lateralOut) - target.maxSpeed;
+        if (overturn > 0) lateralOut -= lateralOut > 0 ? overturn : -overturn;
+        prevLateral = lateralOut;
+        prevAngular = angularOut;
+
+        drivetrain.leftMotors->move(lateralOut + angularOut);
+        drivetrain.rightMotors->move(lateralOut - angularOut);
+
+        if (advance) {
+            const ChainTarget& next = targets[index + 1];
+            if (target.type == ChainTargetType::HEADING) {
+                fromX = measured.x;
+                fromY = measured.y;
+            } else {
+                fromX = target.x;
+                fromY = target.y;
+            }
+            // stopping to turn or change direction, the distance left starts over
+            if (!drivesThrough(target, next)) lateralPID.reset();
+            index++;
+        }
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+
+void Chassis::followTrajectory(Trajectory trajectory, int timeout, Ramsete controller, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { followTrajectory(trajectory, timeout, controller, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    if (trajectory.empty()) {
+        this->endMotion();
+        return;
+    }
+
+    // the speed a motor command of 127 gets, to turn the trajectory's speeds into commands
+    const float maxSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    const float end = std::min((trajectory.duration() + TRAJECTORY_SETTLE_TIME) * 1000, float(stretchTimeout(timeout)));
+    lemlib::Pose lastPose = getPose(true, true);
+    float prevForward = 0;
+    distTraveled = 0;
+    const uint32_t start = pros::millis();
+    uint32_t lastTime = start;
+    while (this->motionRunning && pros::millis() - start < end) {
+        const lemlib::Pose measured = getPose(true, true);
+        const uint32_t now = pros::millis();
+        const float speed = now > lastTime ? measured.distance(lastPose) / (now - lastTime) * 1000 : 0;
+        distTraveled += measured.distance(lastPose);
+        lastPose = measured;
+        lastTime = now;
+        const lemlib::Pose pose = getControlPose(true, true);
+
+        // past the end, keep correcting until the robot has caught up and stopped, so it isn't cut off mid-stride.
+        // Where the robot is now is checked against where the trajectory is now
+        const float elapsed = (now - start) / 1000.0f;
+        const TrajectoryState current = trajectory.sample(elapsed);
+        if (elapsed >= trajectory.duration() && measured.distance({current.x, current.y}) < TRAJECTORY_END_TOLERANCE &&
+            speed < TRAJECTORY_END_SPEED) {
+            break;
+        }
+        // the command lands latency from now, so track where the trajectory will be by then, and ask for the speeds
+        // the drive has to be heading for to get there as it lags behind
+        const TrajectoryState goal = trajectory.sample(elapsed + latency, timeConstant);
+        const TrackerOutput output = controller.calculate(pose.x, pose.y, pose.theta, goal);
+        // the lateral slew, and with it the traction, thermal and capacity caps, limits how hard it speeds up
+        float forward = output.velocity / maxSpeed * 127;
+        if (lateralSettings.slew > 0 && std::fabs(forward) > std::fabs(prevForward)) {
+            forward = lemlib::slew(forward, prevForward, lateralSettings.slew);
+        }
+        prevForward = forward;
+        const float turn = output.angularVelocity * drivetrain.trackWidth / 2 / maxSpeed * 127;
+        float leftVel = forward - turn;
+        float rightVel = forward + turn;
+        const float ratio = std::max(std::fabs(leftVel), std::fabs(rightVel)) / 127;
+        if (ratio > 1) {
+            leftVel /= ratio;
+            rightVel /= ratio;
+        }
+        drivetrain.leftMotors->move(leftVel);
+        drivetrain.rightMotors->move(rightVel);
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+
+void Chassis::setAngularSchedule(const GainSchedule* schedule) {
+    angularSchedule = schedule;
+    tuningLog = TuningLog(schedule == nullptr ? 0 : schedule->bands());
+}
+
+void Chassis::setTuningMode(bool enabled) { tuningMode = enabled; }
+
+const TuningLog& Chassis::getTuningLog() const { return tuningLog; }
+
+void Chassis::turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params, bool async) {
+    if (angularSchedule == nullptr) {
+        lemlib::Chassis::turnToHeading(theta, stretchTimeout(timeout), params, async);
+        return;
+    }
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { turnToHeading(theta, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    ScheduledPID pid(*angularSchedule, angularSettings.windupRange, true);
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    TurnMetrics metrics(angularSettings.smallError);
+    const float startHeading = getPose().theta;
+    float prevHeading = startHeading;
+    float prevError = 0;
+    float prevOutput = 0;
+    bool settling = false;
+    bool first = true;
+    distTraveled = 0;
+    const uint32_t start = pros::millis();
+    uint32_t prevTime = start;
+    while (this->motionRunning && !angularLargeExit.getExit() && !angularSmallExit.getExit() &&
+           pros::millis() - start < uint32_t(stretchTimeout(timeout))) {
+        const float heading = getPose().theta;
+        const uint32_t now = pros::millis();
+        distTraveled = std::fabs(lemlib::angleError(heading, startHeading, false));
+        // degrees per second, from the change in heading since the last iteration
+        const float velocity =
+            now > prevTime ? lemlib::angleError(heading, prevHeading, false) * 1000 / (now - prevTime) : 0;
+        prevHeading = heading;
+        prevTime = now;
+
+        // the short way error changes sign when the robot crosses the target, like LemLib checks. It also changes
+        // sign at the heading opposite the target, which a forced direction can drive through, so that one is
+        // ignored. Once across, always take the short way back. Crossing, settling and exiting go by where the robot
+        // is pointing now
+        const float shortError = lemlib::angleError(theta, heading, false);
+        if (!first && std::signbit(shortError) != std::signbit(prevError) && std::fabs(shortError) < 90) {
+            settling = true;
+        }
+        prevError = shortError;
+        const float error = settling ? shortError : lemlib::angleError(theta, heading, false, params.direction);
+        // steer by where the robot will be pointing when the output lands
+        const float controlHeading = getControlPose().theta;
+        const float controlError = settling ? lemlib::angleError(theta, controlHeading, false)
+                                            : lemlib::angleError(theta, controlHeading, false, params.direction);
+        if (first) metrics.start(error, now);
+        first = false;
+        metrics.update(error, velocity, now);
+
+        // exit early when chaining into the next motion
+        if (params.minSpeed != 0 && (std::fabs(error) < params.earlyExitRange || settling)) break;
+        angularLargeExit.update(error);
+        angularSmallExit.update(error);
+
+        float output = pid.update(controlError, velocity);
+        output = std::clamp(output, -float(params.maxSpeed), float(params.maxSpeed));
+        if (!settling && angularSettings.slew > 0) output = lemlib::slew(output, prevOutput, angularSettings.slew);
+        if (params.minSpeed != 0 && std::fabs(output) < params.minSpeed) {
+            output = output < 0 ? -params.minSpeed : params.minSpeed;
+        }
+        prevOutput = output;
+
+        drivetrain.leftMotors->move(output);
+        drivetrain.rightMotors->move(-output);
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    if (tuningMode) {
+        const TurnResult result = metrics.finish();
+        const size_t band = angularSchedule->band(result.turn);
+        tuningLog.record(band, result);
+        const TurnResult average = tuningLog.average(band);
+        lemlib::infoSink()->info("turn {:.0f}deg (band {}): settled {}ms, overshoot {:.1f}deg, final {:.2f}deg, peak "
+                                 "{:.0f}deg/s",
+                                 result.turn, band, result.settleTime, result.overshoot, result.finalError,
+                                 result.peakVelocity);
+        lemlib::infoSink()->info("band {} average of {}: settled {}ms, overshoot {:.1f}deg, final {:.2f}deg", band,
+                                 tuningLog.count(band), average.settleTime, average.overshoot, average.finalError);
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+
+// LemLib's moveToPoint, steering by the control pose. Everything that decides when to stop uses the measured pose
+void Chassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params, bool async) {
+    if (latency <= 0) {
+        lemlib::Chassis::moveToPoint(x, y, stretchTimeout(timeout), params, async);
+        return;
+    }
+    params.earlyExitRange = std::fabs(params.earlyExitRange);
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { moveToPoint(x, y, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+
+    lemlib::Pose lastPose = getPose(true, true);
+    distTraveled = 0;
+    bool close = false;
+    float prevLateralOut = 0;
+    std::optional<bool> prevSide = std::nullopt;
+    lemlib::Pose target(x, y);
+    target.theta = lastPose.angle(target);
+
+    const uint32_t start = pros::millis();
+    while (pros::millis() - start < uint32_t(stretchTimeout(timeout)) &&
+           ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) && this->motionRunning) {
+        const lemlib::Pose measured = getPose(true, true);
+        distTraveled += measured.distance(lastPose);
+        lastPose = measured;
+        const lemlib::Pose pose = getControlPose(true, true);
+
+        // close enough to start settling
+        const float measuredDistance = measured.distance(target);
+        if (measuredDistance < 7.5 && !close) {
+            close = true;
+            params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+        }
+
+        // motion chaining
+        const bool side = (measured.y - target.y) * -std::sin(target.theta) <=
+                          (measured.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        if (prevSide == std::nullopt) prevSide = side;
+        if (side != prevSide && params.minSpeed != 0) break;
+        prevSide = side;
+
+        const float measuredError =
+            measuredDistance * std::cos(lemlib::angleError(measured.theta, measured.angle(target)));
+        lateralSmallExit.update(measuredError);
+        lateralLargeExit.update(measuredError);
+
+        // steer by where the robot will be when this command lands
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = lemlib::angleError(adjustedRobotTheta, pose.angle(target));
+        const float lateralError = pose.distance(target) * std::cos(lemlib::angleError(pose.theta, pose.angle(target)));
+
+        float lateralOut = lateralPID.update(lateralError);
+        float angularOut = angularPID.update(lemlib::radToDeg(angularError));
+        if (close) angularOut = 0;
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        if (!close) lateralOut = lemlib::slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // prevent moving in the wrong direction, and keep up the minimum speed
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+        if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0) {
+            lateralOut = std::fabs(params.minSpeed);
+        }
+        if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0) {
+            lateralOut = -std::fabs(params.minSpeed);
+        }
+        prevLateralOut = lateralOut;
+
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+        pros::delay(10);
+    }
+
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+
+void Chassis::moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params, bool async) {
+    lemlib::Chassis::moveToPose(x, y, theta, stretchTimeout(timeout), params, async);
+}
+
+RelayResult Chassis::autotuneLateral(AutotuneSettings settings) {
+    this->requestMotionStart();
+    if (!this->motionRunning) return {false, 0, 0, 0};
+    // distance driven along the starting heading
+    const lemlib::Pose start = getPose(true, true);
+    const RelayResult result = autotune(
+        [&] {
+            const lemlib::Pose pose = getPose(true, true);
+            return (pose.x - start.x) * std::cos(start.theta) + (pose.y - start.y) * std::sin(start.theta);
+        },
+        [&](float output) {
+            drivetrain.leftMotors->move(output);
+            drivetrain.rightMotors->move(output);
+        },
+        0, settings);
+    this->endMotion();
+    return result;
+}
+
+RelayResult Chassis::autotuneAngular(AutotuneSettings settings) {
+    this->requestMotionStart();
+    if (!this->motionRunning) return {false, 0, 0, 0};
+    const float start = getPose().theta;
+    const RelayResult result = autotune(
+        // heading change from the start, clockwise positive like turnToHeading's error
+        [&] { return lemlib::angleError(getPose().theta, start, false); },
+        [&](float output) {
+            drivetrain.leftMotors->move(output);
+            drivetrain.rightMotors->move(-output);
+        },
+        0, settings);
+    this->endMotion();
+    return result;
+}
+
+// lemlib::PID's gains are const, so the controller is rebuilt in place
+void Chassis::setLateralGains(const Gains& gains) {
+    lateralSettings.kP = gains.kP;
+    lateralSettings.kI = gains.kI;
+    lateralSettings.kD = gains.kD;
+    std::destroy_at(&lateralPID);
+    std::construct_at(&lateralPID, gains.kP, gains.kI, gains.kD, lateralSettings.windupRange, true);
+}
+
+void Chassis::setAngularGains(const Gains& gains) {
+    angularSettings.kP = gains.kP;
+    angularSettings.kI = gains.kI;
+    angularSettings.kD = gains.kD;
+    std::destroy_at(&angularPID);
+    std::construct_at(&angularPID, gains.kP, gains.kI, gains.kD, angularSettings.windupRange, true);
+}
+
+void Chassis::setPose(float x, float y, float theta, bool radians) {
+    {
+        std::lock_guard lock(poseMutex);
+        lemlib::Chassis::setPose(x, y, theta, radians);
+    }
+    for (const auto& callback : poseResetCallbacks) callback(getPose());
+}
+
+void Chassis::setPose(lemlib::Pose pose, bool radians) { setPose(pose.x, pose.y, pose.theta, radians); }
+
+void Chassis::onPoseReset(std::function<void(lemlib::Pose)> callback) {
+    poseResetCallbacks.push_back(std::move(callback));
+}
+
+void Chassis::correctPose(float x, float y, float error) {
+    PoseCorrection correction {{0, 0, 0}, x, y, error};
+    {
+        std::lock_guard lock(poseMutex);
+        const lemlib::Pose pose = getPose();
+        lemlib::Chassis::setPose(pose.x + x, pose.y + y, pose.theta);
+        correction.pose = getPose();
+    }
+    for (const auto& callback : poseCorrectionCallbacks) callback(correction);
+}
+
+void Chassis::onPoseCorrection(std::function<void(const PoseCorrection&)> callback) {
+    poseCorrectionCallbacks.push_back(std::move(callback));
+}
+
+void Chassis::setAccelerationCap(float slew) {
+    std::lock_guard lock(slewMutex);
+    accelerationCap = slew;
+    applySlew();
+}
+
+void Chassis::setThermalCap(float slew) {
+    std::lock_guard lock(slewMutex);
+    thermalCap = slew;
+    applySlew();
+}
+
+void Chassis::setDriveCapacity(float capacity) {
+    std::lock_guard lock(slewMutex);
+    driveCapacity = std::clamp(capacity, 0.25f, 1.0f);
+    applySlew();
+}
+
+// the motions read lateralSettings.slew every iteration, so changing it is enough
+void Chassis::applySlew() {
+    if (!slewReplaced) lateralSlew = lateralSettings.slew;
+    // with no slew of its own the controller may step straight to full power. A drive short of torque speeds up slower
+    // than that, so it gets a limit scaled from how fast a full one does instead
+    const float fullSlew = lateralSlew > 0 || driveCapacity >= 1 ? lateralSlew : FULL_TORQUE_SLEW;
+    float slew = fullSlew * driveCapacity;
+    // a slew of 0 means no limit, so any cap is tighter than that
+    for (const float cap : {accelerationCap, thermalCap}) {
+        if (cap > 0 && (slew <= 0 || cap < slew)) slew = cap;
+    }
+    slewReplaced = slew != lateralSlew;
+    lateralSettings.slew = slew;
+}
+
+int Chassis::stretchTimeout(int timeout) const { return timeout > 0 ? std::lround(timeout / driveCapacity) : timeout; }
+
+const lemlib::Drivetrain& Chassis::getDrivetrain() const { return drivetrain; }
+
+void Chassis::setDriveGeometry(float trackWidth, float wheelDiameter) {
+    drivetrain.trackWidth = trackWidth;
+    drivetrain.wheelDiameter = wheelDiameter;
+}
+
+// calibrate() makes the drive wheel tracking wheels from the drive motors, so sensors.vertical1 and vertical2 are
+// the left and right drive wheels by the time these run
+SpinMeasurement Chassis::measureSpin(float turns, float speed, int timeout) {
+    this->requestMotionStart();
+    if (!this->motionRunning) return {0, 0, 0, 0};
+    const float left = sensors.vertical1->getDistanceTraveled();
+    const float right = sensors.vertical2->getDistanceTraveled();
+    const float lateral = sensors.horizontal1 != nullptr ? sensors.horizontal1->getDistanceTraveled() : 0;
+    const float rotation = sensors.imu->get_rotation();
+    const float direction = turns >= 0 ? 1 : -1;
+    const uint32_t start = pros::millis();
+    uint32_t now = start;
+    while (std::fabs(sensors.imu->get_rotation() - rotation) < std::fabs(turns) * 360 &&
+           pros::millis() - start < uint32_t(timeout)) {
+        drivetrain.leftMotors->move(direction * speed);
+        drivetrain.rightMotors->move(-direction * speed);
+        pros::Task::delay_until(&now, 10);
+    }
+    drivetrain.leftMotors->brake();
+    drivetrain.rightMotors->brake();
+    // the robot keeps turning a little after the motors stop, and every sensor has to see all of it
+    pros::delay(500);
+    const SpinMeasurement measurement {
+        sensors.vertical1->getDistanceTraveled() - left, sensors.vertical2->getDistanceTraveled() - right,
+        sensors.horizontal1 != nullptr ? sensors.horizontal1->getDistanceTraveled() - lateral : 0,
+        float((sensors.imu->get_rotation() - rotation) * M_PI / 180)};
+    this->endMotion();
+    return measurement;
+}
+
+StraightMeasurement Chassis::measureWallRun(float speed, int timeout) {
+    this->requestMotionStart();
+    if (!this->motionRunning) return {0, 0};
+    const float left = sensors.vertical1->getDistanceTraveled();
+    const float right = sensors.vertical2->getDistanceTraveled();
+    const uint32_t start = pros::millis();
+    uint32_t now = start;
+    float prevDistance = 0;
+    int stalled = 0;
+    // stopped for 200ms, once it has had time to get going
+    while (stalled < 20 && pros::millis() - start < uint32_t(timeout)) {
+        drivetrain.leftMotors->move(speed);
+        drivetrain.rightMotors->move(speed);
+        pros::Task::delay_until(&now, 10);
+        const float distance = (sensors.vertical1->getDistanceTraveled() - left +
+                                sensors.vertical2->getDistanceTraveled() - right) / 2;
+        if (pros::millis() - start > 500 && std::fabs(distance - prevDistance) < 0.01) stalled++;
+        else stalled = 0;
+        prevDistance = distance;
+    }
+    drivetrain.leftMotors->brake();
+    drivetrain.rightMotors->brake();
+    pros::delay(200);
+    const StraightMeasurement measurement {sensors.vertical1->getDistanceTraveled() - left,
+                                           sensors.vertical2->getDistanceTraveled() - right};
+    this->endMotion();
+    return measurement;
+}
+
+void Chassis::setLatency(float latency) { this->latency = std::fmax(latency, 0.0f) / 1000; }
+
+float Chassis::getLatency() const { return latency * 1000; }
+
+void Chassis::setTimeConstant(float timeConstant) { this->timeConstant = std::fmax(timeConstant, 0.0f) / 1000; }
+
+float Chassis::getTimeConstant() const { return timeConstant * 1000; }
+
+lemlib::Pose Chassis::getControlPose(bool radians, bool standardPos) {
+    if (latency <= 0) return getPose(radians, standardPos);
+    // estimatePose works in compass radians, the same as odometry
+    lemlib::Pose pose = lemlib::estimatePose(latency, true);
+    if (standardPos) pose.theta = M_PI_2 - pose.theta;
+    if (!radians) pose.theta = lemlib::radToDeg(pose.theta);
+    return pose;
+}
+
+StepResponse Chassis::measureLatency(float power, int trials) {
+    this->requestMotionStart();
+    if (!this->motionRunning) return {false, 0, 0, 0};
+    const auto distance = [this] {
+        return (sensors.vertical1->getDistanceTraveled() + sensors.vertical2->getDistanceTraveled()) / 2;
+    };
+    StepResponse average {false, 0, 0, 0};
+    int fits = 0;
+    for (int i = 0; i < trials; i++) {
+        const float direction = i % 2 == 0 ? 1 : -1;
+        drivetrain.leftMotors->brake();
+        drivetrain.rightMotors->brake();
+        pros::delay(500);
+
+        // velocity over each 10ms, which is what odometry sees. The first is the robot at rest before the step
+        std::vector<float> velocities {0};
+        float prevDistance = distance();
+        uint32_t now = pros::millis();
+        drivetrain.leftMotors->move(direction * power);
+        drivetrain.rightMotors->move(direction * power);
+        for (int j = 0; j < 50; j++) {
+            pros::Task::delay_until(&now, 10);
+            const float current = distance();
+            velocities.push_back(direction * (current - prevDistance) / 0.01f);
+            prevDistance = current;
+        }
+        // each velocity is the average over its 10ms, so it belongs halfway through
+        const StepResponse response = fitStepResponse(velocities, 0.01, -0.005);
+        if (!response.valid) continue;
+        average.deadTime += response.deadTime;
+        average.timeConstant += response.timeConstant;
+        average.finalValue += response.finalValue;
+        fits++;
+    }
+    drivetrain.leftMotors->brake();
+    drivetrain.rightMotors->brake();
+    this->endMotion();
+    if (fits == 0) return average;
+    average = {true, average.deadTime / fits, average.timeConstant / fits, average.finalValue / fits};
+    lemlib::infoSink()->info("latency: {:.1f}ms dead time, {:.0f}ms time constant, {:.1f}in/s at {} power",
+                             average.deadTime * 1000, average.timeConstant * 1000, average.finalValue, power);
+    return average;
+}
+
+template <typename Pursuit> void Chassis::followPursuit(Pursuit& pursuit, int timeout, bool forwards) {
+    float prevVelocity = 0;
+    distTraveled = 0;
+    const uint32_t start = pros::millis();
+    while (this->motionRunning && pros::millis() - start < uint32_t(stretchTimeout(timeout))) {
+        // how far along the path the robot is, and so when it is done, goes by where it is now
+        lemlib::Pose measured = this->getPose(true, true);
+        if (!forwards) measured.theta -= M_PI;
+        const PursuitCommand command = pursuit.update(measured.x, measured.y, measured.theta);
+        distTraveled = pursuit.getDistanceTraveled();
+        if (command.done) break;
+
+        // the arc to the lookahead point starts from where the robot will be when the output lands
+        lemlib::Pose pose = this->getControlPose(true, true);
+        if (!forwards) pose.theta -= M_PI;
+        const float curvature = pursuit.curvatureFrom(pose.x, pose.y, pose.theta);
+
+        // the lateral slew, and with it the traction, thermal and capacity caps, limits how hard it speeds up
+        float velocity = command.velocity;
+        if (lateralSettings.slew > 0 && velocity > prevVelocity) {
+            velocity = lemlib::slew(velocity, prevVelocity, lateralSettings.slew);
+        }
+        prevVelocity = velocity;
+
+        // positive curvature turns left, so the right side goes faster
+        float leftVel = velocity * (2 - curvature * drivetrain.trackWidth) / 2;
+        float rightVel = velocity * (2 + curvature * drivetrain.trackWidth) / 2;
+        const float ratio = std::max(std::fabs(leftVel), std::fabs(rightVel)) / 127;
+        if (ratio > 1) {
+            leftVel /= ratio;
+            rightVel /= ratio;
+        }
+
+        if (forwards) {
+            drivetrain.leftMotors->move(leftVel);
+            drivetrain.rightMotors->move(rightVel);
+        } else {
+            drivetrain.leftMotors->move(-rightVel);
+            drivetrain.rightMotors->move(-leftVel);
+        }
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+} // namespace kachow
@@ -0,0 +1,64 @@
+#include "kachow/config.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace kachow {
+
+bool Config::load(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) return false;
+    char line[128];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') continue;
+        char* equals = strchr(line, '=');
+        if (equals == nullptr) continue;
+        *equals = '\0';
+        values[line] = equals + 1;
+    }
+    fclose(file);
+    return true;
+}
+
+bool Config::save(const std::string& path) const {
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    for (const auto& [key, value] : values) fprintf(file, "%s=%s\n", key.c_str(), value.c_str());
+    fclose(file);
+    return true;
+}
+
+bool Config::has(const std::string& key) const { return values.contains(key); }
+
+std::string Config::getString(const std::string& key, const std::string& fallback) const {
+    const auto it = values.find(key);
+    return it == values.end() ? fallback : it->second;
+}
+
+float Config::getFloat(const std::string& key, float fallback) const {
+    const auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    char* end;
+    const float value = strtof(it->second.c_str(), &end);
+    return end == it->second.c_str() ? fallback : value;
+}
+
+int Config::getInt(const std::string& key, int fallback) const {
+    const auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    char* end;
+    const long value = strtol(it->second.c_str(), &end, 10);
+    return end == it->second.c_str() ? fallback : int(value);
+}
+
+void Config::set(const std::string& key, const std::string& value) { values[key] = value; }
+
+void Config::set(const std::string& key, float value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    values[key] = buffer;
+}
+
+void Config::set(const std::string& key, int value) { values[key] = std::to_string(value); }
+} // namespace kachow
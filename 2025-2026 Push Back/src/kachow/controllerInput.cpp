@@ -0,0 +1,183 @@
+#include "kachow/controllerInput.hpp"
+#include "pros/rtos.hpp"
+
+namespace kachow {
+
+ControllerInput::ControllerInput(pros::Controller* controller, uint32_t debounceTime, uint32_t doubleTapTime,
+                                 uint32_t longPressTime)
+    : controller(controller),
+      debounceTime(debounceTime),
+      doubleTapTime(doubleTapTime),
+      longPressTime(longPressTime) {}
+
+size_t ControllerInput::index(pros::controller_digital_e_t button) {
+    return button - pros::E_CONTROLLER_DIGITAL_L1;
+}
+
+ControllerInput::Buttons ControllerInput::toMask(std::initializer_list<pros::controller_digital_e_t> combo) {
+    Buttons mask;
+    for (pros::controller_digital_e_t button : combo) mask.set(index(button));
+    return mask;
+}
+
+void ControllerInput::update() {
+    Buttons raw;
+    for (size_t i = 0; i < raw.size(); i++) {
+        if (!watchedButtons[i]) continue;
+        raw[i] = controller->get_digital(pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i));
+    }
+    std::array<int32_t, 4> axisValues {};
+    for (size_t i = 0; i < axisValues.size(); i++) {
+        if (watchedAxes[i]) axisValues[i] = controller->get_analog(pros::controller_analog_e_t(i));
+    }
+    update(raw, axisValues, pros::millis());
+}
+
+void ControllerInput::pollFast(pros::controller_analog_e_t axis) {
+    watchedAxes.set(axis);
+    fastAxes.set(axis);
+}
+
+void ControllerInput::pollFast(std::initializer_list<pros::controller_digital_e_t> buttons) {
+    fastButtons |= toMask(buttons);
+    watchedButtons |= fastButtons;
+}
+
+bool ControllerInput::poll() {
+    for (size_t i = 0; i < fastButtons.size(); i++) {
+        if (!fastButtons[i]) continue;
+        const bool raw = controller->get_digital(pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i));
+        if (raw != lastSample[i]) return true;
+    }
+    for (size_t i = 0; i < fastAxes.size(); i++) {
+        if (fastAxes[i] && controller->get_analog(pros::controller_analog_e_t(i)) != axes[i]) return true;
+    }
+    return false;
+}
+
+void ControllerInput::update(Buttons raw, std::array<int32_t, 4> axes, uint32_t now) {
+    inputChanged = raw != lastSample || axes != this->axes;
+    lastSample = raw;
+    this->axes = axes;
+    previous = current;
+    doubleTap.reset();
+    longPress.reset();
+
+    for (size_t i = 0; i < raw.size(); i++) {
+        // debounce: a change only counts once the raw reading has held still long enough
+        if (raw[i] != lastRaw[i]) {
+            lastRaw[i] = raw[i];
+            rawChangeTime[i] = now;
+        }
+        if (raw[i] != current[i] && now - rawChangeTime[i] >= debounceTime) current[i] = raw[i];
+
+        if (current[i] && !previous[i]) {
+            pressTime[i] = now;
+            if (tapPending[i] && now - lastPressTime[i] <= doubleTapTime) {
+                doubleTap[i] = true;
+                tapPending[i] = false;
+            } else {
+                tapPending[i] = true;
+                lastPressTime[i] = now;
+            }
+        }
+        if (!current[i]) longFired[i] = false;
+        else if (!longFired[i] && now - pressTime[i] >= longPressTime) {
+            longPress[i] = true;
+            longFired[i] = true;
+        }
+    }
+
+    for (Binding& binding : bindings) {
+        if (fires(binding, now)) binding.action();
+    }
+}
+
+bool ControllerInput::fires(Binding& binding, uint32_t now) const {
+    const bool active = (current & binding.mask) == binding.mask;
+    const bool wasActive = (previous & binding.mask) == binding.mask;
+    const bool risingEdge = active && !wasActive;
+
+    switch (binding.trigger) {
+        case Trigger::PRESSED: return risingEdge;
+        case Trigger::RELEASED: return !active && wasActive;
+        case Trigger::HELD: return active;
+        case Trigger::DOUBLE_TAP:
+            if (!risingEdge) return false;
+            if (binding.tapPending && now - binding.lastPress <= doubleTapTime) {
+                binding.tapPending = false;
+                return true;
+            }
+            binding.tapPending = true;
+            binding.lastPress = now;
+            return false;
+        case Trigger::LONG_PRESS:
+            if (risingEdge) {
+                binding.activeSince = now;
+                binding.longFired = false;
+            }
+            if (!active || binding.longFired || now - binding.activeSince < longPressTime) return false;
+            binding.longFired = true;
+            return true;
+    }
+    return false;
+}
+
+bool ControllerInput::changed() const { return inputChanged; }
+
+bool ControllerInput::held(pros::controller_digital_e_t button) {
+    watchedButtons.set(index(button));
+    return current[index(button)];
+}
+
+bool ControllerInput::pressed(pros::controller_digital_e_t button) {
+    watchedButtons.set(index(button));
+    return current[index(button)] && !previous[index(button)];
+}
+
+bool ControllerInput::released(pros::controller_digital_e_t button) {
+    watchedButtons.set(index(button));
+    return !current[index(button)] && previous[index(button)];
+}
+
+bool ControllerInput::doubleTapped(pros::controller_digital_e_t button) {
+    watchedButtons.set(index(button));
+    return doubleTap[index(button)];
+}
+
+bool ControllerInput::longPressed(pros::controller_digital_e_t button) {
+    watchedButtons.set(index(button));
+    return longPress[index(button)];
+}
+
+bool ControllerInput::held(std::initializer_list<pros::controller_digital_e_t> combo) {
+    return held(toMask(combo));
+}
+
+bool ControllerInput::held(Buttons combo) {
+    watchedButtons |= combo;
+    return combo.any() && (current & combo) == combo;
+}
+
+int32_t ControllerInput::getAxis(pros::controller_analog_e_t axis) {
+    watchedAxes.set(axis);
+    return axes[axis];
+}
+
+void ControllerInput::bind(std::initializer_list<pros::controller_digital_e_t> combo, Trigger trigger,
+                           std::function<void()> action) {
+    bind(toMask(combo), trigger, std::move(action));
+}
+
+void ControllerInput::bind(Buttons combo, Trigger trigger, std::function<void()> action) {
+    if (combo.none()) return;
+    Binding binding;
+    binding.mask = combo;
+    binding.trigger = trigger;
+    binding.action = std::move(action);
+    watchedButtons |= binding.mask;
+    bindings.push_back(std::move(binding));
+}
+
+void ControllerInput::clearBindings() { bindings.clear(); }
+} // namespace kachow
@@ -0,0 +1,55 @@
+#include "kachow/deviceCache.hpp"
+#include "pros/rtos.hpp"
+
+namespace kachow {
+
+CachedMotorGroup::CachedMotorGroup(pros::MotorGroup* motors, uint32_t refreshPeriod)
+    : motors(motors),
+      command(refreshPeriod),
+      brakeMode(refreshPeriod) {}
+
+void CachedMotorGroup::move(int32_t voltage) {
+    if (command.update({CommandType::MOVE, voltage}, pros::millis())) motors->move(voltage);
+}
+
+void CachedMotorGroup::move_velocity(int32_t velocity) {
+    if (command.update({CommandType::VELOCITY, velocity}, pros::millis())) motors->move_velocity(velocity);
+}
+
+void CachedMotorGroup::move_voltage(int32_t voltage) {
+    if (command.update({CommandType::VOLTAGE, voltage}, pros::millis())) motors->move_voltage(voltage);
+}
+
+void CachedMotorGroup::set_brake_mode(pros::motor_brake_mode_e_t mode) {
+    if (brakeMode.update(mode, pros::millis())) motors->set_brake_mode_all(mode);
+}
+
+void CachedMotorGroup::invalidate() {
+    command.invalidate();
+    brakeMode.invalidate();
+}
+
+WriteStats CachedMotorGroup::getStats() const {
+    const WriteStats a = command.getStats();
+    const WriteStats b = brakeMode.getStats();
+    return {a.sent + b.sent, a.suppressed + b.suppressed};
+}
+
+pros::MotorGroup* CachedMotorGroup::getMotors() const { return motors; }
+
+CachedDigitalOut::CachedDigitalOut(pros::adi::DigitalOut* out, uint32_t refreshPeriod)
+    : out(out),
+      value(refreshPeriod) {}
+
+void CachedDigitalOut::set_value(bool value) {
+    if (this->value.update(value, pros::millis())) out->set_value(value);
+}
+
+bool CachedDigitalOut::get_value() const { return value.getLast(); }
+
+void CachedDigitalOut::toggle() { set_value(!get_value()); }
+
+void CachedDigitalOut::invalidate() { value.invalidate(); }
+
+WriteStats CachedDigitalOut::getStats() const { return value.getStats(); }
+} // namespace kachow
@@ -0,0 +1,192 @@
+#include "kachow/deviceMonitor.hpp"
+#include <cmath>
+#include <cstdlib>
+#include "pros/apix.h"
+#include "pros/error.h"
+#include "pros/motors.h"
+#include "kachow/geometryCalibration.hpp"
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+namespace {
+const char* statusName(DeviceStatus status) {
+    switch (status) {
+        case DeviceStatus::OK: return "OK";
+        case DeviceStatus::DISCONNECTED: return "disconnected";
+        case DeviceStatus::WRONG_DEVICE: return "the wrong device";
+        case DeviceStatus::OVER_TEMP: return "over temperature";
+        case DeviceStatus::FAULT: return "faulted";
+    }
+    return "";
+}
+
+// faults that mean the motor is not delivering what it is asked for. Over temperature is its own status
+constexpr uint32_t MOTOR_FAULTS =
+    pros::E_MOTOR_FAULT_DRIVER_FAULT | pros::E_MOTOR_FAULT_OVER_CURRENT | pros::E_MOTOR_FAULT_DRV_OVER_CURRENT;
+} // namespace
+
+DeviceMonitor::DeviceMonitor(uint32_t period)
+    : period(period) {}
+
+void DeviceMonitor::add(const std::string& name, uint8_t port, pros::DeviceType type, bool optional) {
+    watched.push_back({{name, port, DeviceStatus::OK, 0, 0, 0}, type, nullptr, 0, optional, false});
+}
+
+void DeviceMonitor::add(const std::string& name, pros::MotorGroup* motors) {
+    const std::vector<std::int8_t> ports = motors->get_port_all();
+    for (size_t i = 0; i < ports.size(); i++) {
+        const uint8_t port = std::abs(ports[i]);
+        watched.push_back({{name + " " + std::to_string(port), port, DeviceStatus::OK, 0, 0, 0},
+                           pros::DeviceType::motor,
+                           motors,
+                           i,
+                           false,
+                           false});
+    }
+}
+
+void DeviceMonitor::onChange(std::function<void(const DeviceHealth&)> callback) { callbacks.push_back(callback); }
+
+void DeviceMonitor::start() {
+    if (task != nullptr) return;
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, period);
+            update();
+        }
+    });
+}
+
+std::vector<DeviceHealth> DeviceMonitor::getHealth() const {
+    std::vector<DeviceHealth> health;
+    for (const Watched& device : watched) health.push_back(device.health);
+    return health;
+}
+
+bool DeviceMonitor::allHealthy() const {
+    for (const Watched& device : watched) {
+        if (device.health.status != DeviceStatus::OK) return false;
+    }
+    return true;
+}
+
+void DeviceMonitor::logReport() const {
+    for (const Watched& device : watched) {
+        const DeviceHealth& health = device.health;
+        if (health.disconnects == 0 && health.downTime == 0 && health.status == DeviceStatus::OK) continue;
+        lemlib::infoSink()->warn("{} on port {} is {}: {} disconnects, {}ms down in total", health.name, health.port,
+                                 statusName(health.status), health.disconnects, health.downTime);
+    }
+}
+
+void DeviceMonitor::update() {
+    // a group's faults are read once for all its motors
+    pros::MotorGroup* motors = nullptr;
+    std::vector<uint32_t> faults;
+    std::vector<std::int32_t> overTemp;
+
+    for (Watched& device : watched) {
+        const pros::DeviceType plugged =
+            static_cast<pros::DeviceType>(pros::c::registry_get_plugged_type(device.health.port - 1));
+        // an optional device that has never been there isn't fitted, so there is nothing to have lost
+        if (device.optional && !device.seen) {
+            if (plugged != device.type) continue;
+            device.seen = true;
+            lemlib::infoSink()->info("{} found on port {}", device.health.name, device.health.port);
+        }
+        if (plugged == pros::DeviceType::none) {
+            setStatus(device, DeviceStatus::DISCONNECTED, 0);
+            continue;
+        }
+        if (plugged != device.type) {
+            setStatus(device, DeviceStatus::WRONG_DEVICE, 0);
+            continue;
+        }
+        if (device.motors == nullptr) {
+            setStatus(device, DeviceStatus::OK, 0);
+            continue;
+        }
+
+        if (device.motors != motors) {
+            motors = device.motors;
+            faults = motors->get_faults_all();
+            overTemp = motors->is_over_temp_all();
+        }
+        const uint32_t fault = device.index < faults.size() ? faults[device.index] : PROS_ERR;
+        const std::int32_t hot = device.index < overTemp.size() ? overTemp[device.index] : PROS_ERR;
+        // plugged in but not answering
+        if (fault == uint32_t(PROS_ERR) || hot == PROS_ERR) {
+            setStatus(device, DeviceStatus::DISCONNECTED, 0);
+        } else if (hot || (fault & pros::E_MOTOR_FAULT_MOTOR_OVER_TEMP)) {
+            setStatus(device, DeviceStatus::OVER_TEMP, fault);
+        } else if (fault & MOTOR_FAULTS) {
+            setStatus(device, DeviceStatus::FAULT, fault);
+        } else {
+            setStatus(device, DeviceStatus::OK, fault);
+        }
+    }
+}
+
+void DeviceMonitor::setStatus(Watched& watched, DeviceStatus status, uint32_t faults) {
+    DeviceHealth& health = watched.health;
+    health.faults = faults;
+    if (health.status != DeviceStatus::OK) health.downTime += period;
+    if (status == health.status) return;
+
+    if (status == DeviceStatus::DISCONNECTED) health.disconnects++;
+    health.status = status;
+    if (status == DeviceStatus::OK) {
+        lemlib::infoSink()->info("{} on port {} is back", health.name, health.port);
+    } else {
+        lemlib::infoSink()->warn("{} on port {} is {}", health.name, health.port, statusName(status));
+    }
+    for (const auto& callback : callbacks) callback(health);
+}
+
+GuardedRotation::GuardedRotation(std::int8_t port)
+    : pros::Rotation(port) {}
+
+void GuardedRotation::setFallback(pros::Imu* imu, float diameter, float offset) {
+    this->imu = imu;
+    // what the wheel would read if the robot only turned, left positive like LemLib's odometry expects
+    ticksPerDegree = spinTicksPerDegree(diameter, offset);
+}
+
+std::int32_t GuardedRotation::get_position() const {
+    const std::int32_t raw = pros::Rotation::get_position();
+    if (raw == PROS_ERR) {
+        if (connected) {
+            connected = false;
+            lostRotation = imu != nullptr ? imu->get_rotation() : 0;
+        }
+        return fallbackPosition();
+    }
+    // back, so carry on from wherever the fallback got to
+    if (!connected) {
+        offset = fallbackPosition() - raw;
+        connected = true;
+    }
+    last = raw + offset;
+    return last;
+}
+
+std::int32_t GuardedRotation::reset_position() const { return set_position(0); }
+
+std::int32_t GuardedRotation::set_position(std::int32_t position) const {
+    offset = 0;
+    last = position;
+    lostRotation = imu != nullptr && !connected ? imu->get_rotation() : 0;
+    return pros::Rotation::set_position(position);
+}
+
+bool GuardedRotation::isConnected() const { return connected; }
+
+std::int32_t GuardedRotation::fallbackPosition() const {
+    if (imu == nullptr) return last;
+    const double rotation = imu->get_rotation();
+    if (!std::isfinite(rotation) || !std::isfinite(lostRotation)) return last;
+    return last + std::lround((rotation - lostRotation) * ticksPerDegree);
+}
+} // namespace kachow
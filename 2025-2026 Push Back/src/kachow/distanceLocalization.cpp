@@ -0,0 +1,57 @@
+#include "kachow/distanceLocalization.hpp"
+#include <cmath>
+#include "lemlib/chassis/odom.hpp"
+#include "pros/error.h"
+
+namespace kachow {
+
+namespace {
+// how far off a corrected position may be, in inches. The sensors are good to a fraction of an inch, but each
+// correction only goes part of the way and the next one sees the same wall, so they are far from independent
+constexpr float WALL_FIX_ERROR = 2;
+} // namespace
+
+DistanceLocalization::DistanceLocalization(Chassis* chassis, std::vector<pros::Distance*> sensors,
+                                           WallLocalizer localizer)
+    : chassis(chassis),
+      sensors(std::move(sensors)),
+      localizer(std::move(localizer)),
+      readings(this->sensors.size()) {}
+
+void DistanceLocalization::start() {
+    if (task != nullptr) return;
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            if (enabled) update();
+            pros::Task::delay_until(&now, 10);
+        }
+    });
+}
+
+void DistanceLocalization::setEnabled(bool enabled) { this->enabled = enabled; }
+
+LocalizationStats DistanceLocalization::getStats() const { return stats; }
+
+void DistanceLocalization::update() {
+    for (size_t i = 0; i < sensors.size(); i++) {
+        const int32_t distance = sensors[i]->get_distance();
+        // unplugged, or nothing in range. An object size of 0 makes the localizer skip it
+        if (distance == PROS_ERR || distance >= 9999) {
+            readings[i] = {0, 0, 0};
+            continue;
+        }
+        readings[i] = {distance / 25.4f, sensors[i]->get_confidence(), sensors[i]->get_object_size()};
+    }
+
+    const lemlib::Pose pose = chassis->getPose();
+    const lemlib::Pose speed = lemlib::getSpeed();
+    const Correction correction = localizer.correct(pose.x, pose.y, pose.theta, speed.x, speed.y, readings);
+    stats.last = correction;
+    if (correction.sensors == 0) return;
+    // odometry only works from changes in its sensors, so moving the pose under it is safe
+    chassis->correctPose(correction.x, correction.y, WALL_FIX_ERROR);
+    stats.corrections++;
+    stats.totalShift += std::hypot(correction.x, correction.y);
+}
+} // namespace kachow
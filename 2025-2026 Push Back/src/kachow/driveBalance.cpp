@@ -0,0 +1,62 @@
+#include "kachow/driveBalance.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+DriveBalance::DriveBalance(BalanceSettings settings)
+    : settings(settings) {}
+
+void DriveBalance::update(const std::vector<MotorSample>& left, const std::vector<MotorSample>& right, float dt) {
+    leftCapacity = sideCapacity(left, leftStripFor, dt);
+    rightCapacity = sideCapacity(right, rightStripFor, dt);
+}
+
+float DriveBalance::getLeftScale() const {
+    if (leftCapacity <= 0 || rightCapacity <= 0) return 1;
+    return std::min(rightCapacity / leftCapacity, 1.0f);
+}
+
+float DriveBalance::getRightScale() const {
+    if (leftCapacity <= 0 || rightCapacity <= 0) return 1;
+    return std::min(leftCapacity / rightCapacity, 1.0f);
+}
+
+float DriveBalance::getCapacity() const { return std::min(leftCapacity, rightCapacity); }
+
+float DriveBalance::getLeftCapacity() const { return leftCapacity; }
+
+float DriveBalance::getRightCapacity() const { return rightCapacity; }
+
+float DriveBalance::sideCapacity(const std::vector<MotorSample>& side, std::vector<float>& stripFor, float dt) {
+    if (side.empty()) return 0;
+    stripFor.resize(side.size(), 0);
+
+    std::vector<float> velocities;
+    for (const MotorSample& motor : side) {
+        if (std::isfinite(motor.velocity)) velocities.push_back(motor.velocity);
+    }
+    // with fewer than three there is no telling which motor is the odd one out
+    const bool compare = velocities.size() >= 3;
+    float median = 0;
+    if (compare) {
+        std::nth_element(velocities.begin(), velocities.begin() + velocities.size() / 2, velocities.end());
+        median = velocities[velocities.size() / 2];
+    }
+
+    float capacity = 0;
+    for (size_t i = 0; i < side.size(); i++) {
+        const MotorSample& motor = side[i];
+        const bool stripped = stripFor[i] >= settings.stripTime;
+        // a stripped gear doesn't heal, so stop checking once it is found
+        if (!stripped && compare && std::isfinite(motor.velocity)) {
+            if (std::fabs(motor.velocity - median) > settings.stripSpeed) stripFor[i] += dt;
+            else stripFor[i] = 0;
+        }
+
+        if (!std::isfinite(motor.velocity) || motor.faulted || stripFor[i] >= settings.stripTime) continue;
+        capacity += motor.overTemp ? settings.overTempCapacity : 1;
+    }
+    return capacity / side.size();
+}
+} // namespace kachow
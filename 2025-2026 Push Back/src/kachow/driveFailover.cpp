@@ -0,0 +1,98 @@
+#include "kachow/driveFailover.hpp"
+#include <cmath>
+#include "pros/error.h"
+#include "pros/motors.h"
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+namespace {
+// from the first motor that answers. Green if none do
+float cartridgeRpm(pros::MotorGroup* motors) {
+    for (const pros::MotorGears gears : motors->get_gearing_all()) {
+        switch (gears) {
+            case pros::MotorGears::red: return 100;
+            case pros::MotorGears::green: return 200;
+            case pros::MotorGears::blue: return 600;
+            default: break;
+        }
+    }
+    return 200;
+}
+
+std::vector<MotorSample> readMotors(pros::MotorGroup* motors, float rpm) {
+    const std::vector<double> velocities = motors->get_actual_velocity_all();
+    const std::vector<uint32_t> faults = motors->get_faults_all();
+    const std::vector<std::int32_t> overTemp = motors->is_over_temp_all();
+    std::vector<MotorSample> samples(motors->size(), {NAN, false, false});
+    for (size_t i = 0; i < samples.size(); i++) {
+        // unplugged motors read PROS_ERR_F and PROS_ERR
+        if (i >= velocities.size() || i >= faults.size() || i >= overTemp.size()) continue;
+        if (!std::isfinite(velocities[i]) || faults[i] == uint32_t(PROS_ERR) || overTemp[i] == PROS_ERR) continue;
+        samples[i] = {float(velocities[i] / rpm), overTemp[i] == 1,
+                      (faults[i] & (pros::E_MOTOR_FAULT_DRIVER_FAULT | pros::E_MOTOR_FAULT_OVER_CURRENT |
+                                    pros::E_MOTOR_FAULT_DRV_OVER_CURRENT)) != 0};
+    }
+    return samples;
+}
+} // namespace
+
+std::int32_t BalancedMotorGroup::move(std::int32_t voltage) const {
+    return pros::MotorGroup::move(std::lround(voltage * scale));
+}
+
+std::int32_t BalancedMotorGroup::move_voltage(std::int32_t voltage) const {
+    return pros::MotorGroup::move_voltage(std::lround(voltage * scale));
+}
+
+void BalancedMotorGroup::setScale(float scale) { this->scale = scale; }
+
+float BalancedMotorGroup::getScale() const { return scale; }
+
+DriveFailover::DriveFailover(Chassis* chassis, BalancedMotorGroup* left, BalancedMotorGroup* right,
+                             BalanceSettings settings)
+    : chassis(chassis),
+      left(left),
+      right(right),
+      balance(settings) {}
+
+void DriveFailover::start() {
+    if (task != nullptr) return;
+    leftRpm = cartridgeRpm(left);
+    rightRpm = cartridgeRpm(right);
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, 20);
+            update(0.02);
+        }
+    });
+}
+
+const DriveBalance& DriveFailover::getBalance() const { return balance; }
+
+void DriveFailover::update(float dt) {
+    balance.update(readMotors(left, leftRpm), readMotors(right, rightRpm), dt);
+    // only act on real changes, so the chassis isn't told the same thing every 20ms
+    if (std::fabs(balance.getLeftCapacity() - prevLeftCapacity) < 0.01 &&
+        std::fabs(balance.getRightCapacity() - prevRightCapacity) < 0.01) {
+        return;
+    }
+    prevLeftCapacity = balance.getLeftCapacity();
+    prevRightCapacity = balance.getRightCapacity();
+
+    const float leftScale = balance.getLeftScale();
+    const float rightScale = balance.getRightScale();
+    left->setScale(leftScale);
+    right->setScale(rightScale);
+    chassis->setDriveCapacity(balance.getCapacity());
+    if (balance.getCapacity() <= 0) {
+        lemlib::infoSink()->warn("a whole side of the drive is out, left {:.0f}% right {:.0f}%",
+                                 balance.getLeftCapacity() * 100, balance.getRightCapacity() * 100);
+    } else {
+        lemlib::infoSink()->warn("drive rebalanced: left {:.0f}% right {:.0f}%, outputs scaled to {:.2f} and {:.2f}",
+                                 balance.getLeftCapacity() * 100, balance.getRightCapacity() * 100, leftScale,
+                                 rightScale);
+    }
+}
+} // namespace kachow
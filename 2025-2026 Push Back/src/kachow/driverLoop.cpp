@@ -0,0 +1,88 @@
+#include "kachow/driverLoop.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "pros/rtos.hpp"
+
+namespace kachow {
+
+void LatencyHistogram::add(uint32_t latency) {
+    const size_t bin = latency / BIN_WIDTH;
+    bins[bin < BINS ? bin : BINS - 1]++;
+    samples++;
+    if (latency > largest) largest = latency;
+}
+
+uint32_t LatencyHistogram::percentile(float percentile) const {
+    if (samples == 0) return 0;
+    const uint32_t target = percentile * samples;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BINS; i++) {
+        seen += bins[i];
+        if (seen > target) return (i + 1) * BIN_WIDTH;
+    }
+    return BINS * BIN_WIDTH;
+}
+
+uint32_t LatencyHistogram::count() const { return samples; }
+
+uint32_t LatencyHistogram::max() const { return largest; }
+
+void LatencyHistogram::reset() {
+    bins.fill(0);
+    samples = 0;
+    largest = 0;
+}
+
+DriverLoop::DriverLoop(ControllerInput* input, LoopMode mode, uint32_t period, uint32_t pollPeriod,
+                       uint32_t reportPeriod)
+    : input(input),
+      mode(mode),
+      period(period),
+      pollPeriod(pollPeriod),
+      reportPeriod(reportPeriod) {}
+
+void DriverLoop::run(std::function<void()> body) {
+    uint32_t wake = pros::millis();
+    uint32_t lastBody = 0;
+    uint64_t previousPoll = pros::micros();
+    uint64_t previousUpdate = previousPoll;
+    while (true) {
+        const uint64_t pollTime = pros::micros();
+        const bool fresh = mode == LoopMode::LOW_LATENCY && input->poll();
+        const uint32_t now = pros::millis();
+
+        if (mode == LoopMode::FREE_RUNNING || fresh || now - lastBody >= period) {
+            const uint64_t updateTime = pros::micros();
+            input->update();
+            body();
+            lastBody = now;
+            // a change the fast poll saw arrived after the poll before, anything else after the last update
+            if (fresh) record(previousPoll, pros::micros());
+            else if (input->changed()) record(previousUpdate, pros::micros());
+            previousUpdate = updateTime;
+        }
+        previousPoll = pollTime;
+        if (reportPeriod != 0 && now - lastReport >= reportPeriod) report(now);
+
+        if (mode == LoopMode::FREE_RUNNING) {
+            pros::delay(period);
+        } else {
+            // a binding can block for a long time (e.g. running an auton), don't try to catch up afterwards
+            if (pros::millis() - wake > period) wake = pros::millis();
+            pros::Task::delay_until(&wake, pollPeriod);
+        }
+    }
+}
+
+const LatencyHistogram& DriverLoop::getLatency() const { return latency; }
+
+void DriverLoop::record(uint64_t previousSample, uint64_t commandTime) {
+    latency.add(commandTime - previousSample);
+}
+
+void DriverLoop::report(uint32_t now) {
+    lastReport = now;
+    lemlib::infoSink()->info("driver latency n={} p50={}us p90={}us p99={}us max={}us", latency.count(),
+                             latency.percentile(0.5), latency.percentile(0.9), latency.percentile(0.99),
+                             latency.max());
+}
+} // namespace kachow
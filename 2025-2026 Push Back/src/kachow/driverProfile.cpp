@@ -0,0 +1,68 @@
+#include "kachow/driverProfile.hpp"
+#include "kachow/config.hpp"
+
+namespace kachow {
+
+namespace {
+constexpr const char* BUTTON_NAMES[12] = {"L1", "L2", "R1", "R2", "UP", "DOWN", "LEFT", "RIGHT", "X", "B", "Y", "A"};
+constexpr const char* DRIVE_MODE_NAMES[3] = {"tank", "arcade", "curvature"};
+
+void loadCurve(const Config& config, const std::string& prefix, CurveSettings& curve) {
+    curve.deadband = config.getFloat(prefix + ".deadband", curve.deadband);
+    curve.minOutput = config.getFloat(prefix + ".minOutput", curve.minOutput);
+    curve.gain = config.getFloat(prefix + ".gain", curve.gain);
+}
+
+void saveCurve(Config& config, const std::string& prefix, const CurveSettings& curve) {
+    config.set(prefix + ".deadband", curve.deadband);
+    config.set(prefix + ".minOutput", curve.minOutput);
+    config.set(prefix + ".gain", curve.gain);
+}
+} // namespace
+
+bool DriverProfile::load(const std::string& path) {
+    Config config;
+    if (!config.load(path)) return false;
+    name = config.getString("name", name);
+    const std::string mode = config.getString("driveMode");
+    for (int i = 0; i < 3; i++) {
+        if (mode == DRIVE_MODE_NAMES[i]) driveMode = DriveMode(i);
+    }
+    loadCurve(config, "throttle", throttle);
+    loadCurve(config, "steer", steer);
+    for (auto& [action, buttons] : bindings) buttons = config.getString("bind." + action, buttons);
+    return true;
+}
+
+bool DriverProfile::save(const std::string& path) const {
+    Config config;
+    config.set("name", name);
+    config.set("driveMode", std::string(DRIVE_MODE_NAMES[int(driveMode)]));
+    saveCurve(config, "throttle", throttle);
+    saveCurve(config, "steer", steer);
+    for (const auto& [action, buttons] : bindings) config.set("bind." + action, buttons);
+    return config.save(path);
+}
+
+CompiledProfile DriverProfile::compile() const {
+    CompiledProfile compiled {driveMode, LutDriveCurve(throttle.deadband, throttle.minOutput, throttle.gain),
+                              LutDriveCurve(steer.deadband, steer.minOutput, steer.gain), {}};
+    for (const auto& [action, buttons] : bindings) compiled.bindings[action] = parseButtons(buttons);
+    return compiled;
+}
+
+ControllerInput::Buttons DriverProfile::parseButtons(const std::string& text) {
+    ControllerInput::Buttons mask;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find('+', start);
+        if (end == std::string::npos) end = text.size();
+        const std::string button = text.substr(start, end - start);
+        for (size_t i = 0; i < 12; i++) {
+            if (button == BUTTON_NAMES[i]) mask.set(i);
+        }
+        start = end + 1;
+    }
+    return mask;
+}
+} // namespace kachow
@@ -0,0 +1,123 @@
+#include "kachow/dualImu.hpp"
+#include <cmath>
+#include "pros/error.h"
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+namespace {
+// every motor that answers is below 1 rpm. Not still if none answer, since then there is no telling
+bool motorsStill(pros::MotorGroup* motors) {
+    bool answered = false;
+    for (const double velocity : motors->get_actual_velocity_all()) {
+        if (!std::isfinite(velocity)) continue;
+        if (std::fabs(velocity) >= 1) return false;
+        answered = true;
+    }
+    return answered;
+}
+
+// an unplugged IMU's status reads as calibrating, so that has to be ruled out first. Always the IMU's own answer, even
+// for a DualImu
+bool calibrating(const pros::Imu& imu) {
+    return imu.get_status() != pros::ImuStatus::error && imu.pros::Imu::is_calibrating();
+}
+} // namespace
+
+DualImu::DualImu(std::uint8_t first, std::uint8_t second, pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors,
+                 HeadingFusionSettings settings)
+    : pros::Imu(first),
+      second(second),
+      leftMotors(leftMotors),
+      rightMotors(rightMotors),
+      fusion(settings) {}
+
+void DualImu::start() {
+    if (task != nullptr) return;
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, 10);
+            update(0.01);
+        }
+    });
+}
+
+std::int32_t DualImu::reset(bool blocking) const {
+    resetPending = true;
+    const std::int32_t first = pros::Imu::reset();
+    const std::int32_t result = second.reset();
+    if (first == PROS_ERR && result == PROS_ERR) return PROS_ERR;
+    if (!blocking) return 1;
+    // the IMUs take a moment to report that they have started calibrating
+    do pros::delay(10);
+    while (is_calibrating());
+    return 1;
+}
+
+bool DualImu::is_calibrating() const { return calibrating(*this) || calibrating(second); }
+
+double DualImu::get_rotation() const { return available ? rotation.load() : PROS_ERR_F; }
+
+double DualImu::get_heading() const {
+    if (!available) return PROS_ERR_F;
+    const double heading = std::fmod(rotation.load(), 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+std::int32_t DualImu::set_rotation(double target) const {
+    offset = offset + target - rotation;
+    rotation = target;
+    return 1;
+}
+
+std::int32_t DualImu::set_heading(double target) const {
+    if (!available) return PROS_ERR;
+    return set_rotation(rotation - get_heading() + target);
+}
+
+std::int32_t DualImu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t DualImu::tare_heading() const { return set_heading(0); }
+
+std::uint8_t DualImu::getSecondPort() const { return second.get_port(); }
+
+DriftReport DualImu::getReport() const { return fusion.getReport(); }
+
+void DualImu::logReport() const {
+    const DriftReport report = getReport();
+    lemlib::infoSink()->info("heading drift over {:.0f}s, {:.0f}s of it still: first IMU alone would be {:.2f} deg "
+                             "off, second {:.2f} deg. Bias {:.3f} and {:.3f} deg/s, {} outliers",
+                             report.runTime, report.stillTime, report.firstDrift, report.secondDrift, report.firstBias,
+                             report.secondBias, report.outliers);
+    if (report.firstDropped) lemlib::infoSink()->warn("first IMU dropped for disagreeing with the second");
+    if (report.secondDropped) lemlib::infoSink()->warn("second IMU dropped for disagreeing with the first");
+}
+
+void DualImu::update(float dt) {
+    if (resetPending.exchange(false)) {
+        fusion.reset();
+        offset = 0;
+        firstSynced = false;
+        secondSynced = false;
+    }
+
+    // change in each IMU's rotation since it was last read, NaN if it can't be read now
+    const auto delta = [](const pros::Imu& imu, double reading, float& prev, bool& synced) {
+        if (!std::isfinite(reading) || calibrating(imu)) {
+            synced = false;
+            return float(NAN);
+        }
+        const float change = synced ? reading - prev : NAN;
+        prev = reading;
+        synced = true;
+        return change;
+    };
+    const float first = delta(*this, pros::Imu::get_rotation(), prevFirst, firstSynced);
+    const float second = delta(this->second, this->second.get_rotation(), prevSecond, secondSynced);
+    available = firstSynced || secondSynced;
+
+    fusion.update({first, second, motorsStill(leftMotors) && motorsStill(rightMotors), dt});
+    rotation = fusion.getHeading() + offset;
+}
+} // namespace kachow
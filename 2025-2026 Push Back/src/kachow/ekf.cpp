@@ -0,0 +1,134 @@
+#include "kachow/ekf.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+float toRadians(float degrees) { return degrees * M_PI / 180; }
+
+// a · b · aᵀ for a 3x3 a and b
+Matrix3 sandwich(const Matrix3& a, const Matrix3& b) {
+    Matrix3 ab {}, result {};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            for (int k = 0; k < 3; k++) ab[i][j] += a[i][k] * b[k][j];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            for (int k = 0; k < 3; k++) result[i][j] += ab[i][k] * a[j][k];
+    return result;
+}
+} // namespace
+
+PoseEkf::PoseEkf(float trackWidth, float trackingOffset, EkfSettings settings)
+    : trackWidth(trackWidth),
+      trackingOffset(trackingOffset),
+      settings(settings) {
+    reset(0, 0, 0);
+}
+
+void PoseEkf::reset(float x, float y, float theta, float positionError, float headingError) {
+    state = {x, y, theta};
+    covariance = {};
+    covariance[0][0] = covariance[1][1] = positionError * positionError;
+    covariance[2][2] = toRadians(headingError) * toRadians(headingError);
+    prevVelocity = 0;
+    slip = 0;
+}
+
+void PoseEkf::predict(const OdometryStep& step) {
+    const float forward = (step.left + step.right) / 2;
+    const float turn = step.headingChange;
+    // the tracking wheel reads left positive, and -offset per radian of turn even when the robot does not slide (see
+    // spinRoll). Take that out, and turn it round to right positive for the compass frame
+    const float lateral = -(step.lateral + trackingOffset * turn);
+
+    // slip: accelerating harder than the wheels can grip, or the wheels turning the robot more than it turned
+    if (step.dt > 0) {
+        const float velocity = forward / step.dt;
+        const float accel = std::fabs(velocity - prevVelocity) / step.dt;
+        prevVelocity = velocity;
+        const float wheelTurn = (step.left - step.right) / trackWidth;
+        const float excessTurn = std::fabs(wheelTurn - turn) - settings.scrubAllowance * std::fabs(turn);
+        const float accelSlip = (accel - settings.slipAccel) / settings.slipAccel;
+        // an excess turn of 1 degree in one step is already a lot
+        const float turnSlip = excessTurn / toRadians(1);
+        slip = std::clamp(std::max(accelSlip, turnSlip), 0.0f, 1.0f);
+    }
+    slip = std::max(slip, std::clamp(step.slip, 0.0f, 1.0f));
+
+    // move along the arc using the heading halfway through the step
+    const float theta = state[2] + turn / 2;
+    const float sin = std::sin(theta), cos = std::cos(theta);
+    state[0] += forward * sin + lateral * cos;
+    state[1] += forward * cos - lateral * sin;
+    state[2] += turn;
+
+    // jacobian of the motion with respect to the state
+    const float dxdTheta = forward * cos - lateral * sin;
+    const float dydTheta = -forward * sin - lateral * cos;
+    const Matrix3 f {{{1, 0, dxdTheta}, {0, 1, dydTheta}, {0, 0, 1}}};
+    // and with respect to forward, lateral and turn, whose noise is independent
+    const Matrix3 g {{{sin, cos, dxdTheta / 2}, {cos, -sin, dydTheta / 2}, {0, 0, 1}}};
+    const float forwardNoise = (settings.encoderNoise + slip * settings.slipNoise) * std::fabs(forward);
+    const float lateralNoise = settings.trackingNoise * std::fabs(step.lateral);
+    const float turnNoise = toRadians(settings.gyroNoise);
+    const Matrix3 noise {{{forwardNoise * forwardNoise, 0, 0},
+                          {0, lateralNoise * lateralNoise, 0},
+                          {0, 0, turnNoise * turnNoise}}};
+
+    covariance = sandwich(f, covariance);
+    const Matrix3 q = sandwich(g, noise);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) covariance[i][j] += q[i][j];
+    covariance[0][0] += settings.processNoise * settings.processNoise;
+    covariance[1][1] += settings.processNoise * settings.processNoise;
+}
+
+void PoseEkf::updateHeading(float theta, float error) {
+    if (error < 0) error = settings.headingNoise;
+    const float innovation = std::remainder(theta - state[2], 2 * M_PI);
+    update({0, 0, 1}, innovation, toRadians(error) * toRadians(error));
+}
+
+void PoseEkf::updatePosition(float x, float y, float error) {
+    if (std::isfinite(x)) update({1, 0, 0}, x - state[0], error * error);
+    if (std::isfinite(y)) update({0, 1, 0}, y - state[1], error * error);
+}
+
+void PoseEkf::update(const std::array<float, 3>& h, float innovation, float variance) {
+    // p · hᵀ
+    std::array<float, 3> ph {};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) ph[i] += covariance[i][j] * h[j];
+    float s = variance;
+    for (int i = 0; i < 3; i++) s += h[i] * ph[i];
+    if (s <= 0) return;
+
+    std::array<float, 3> gain;
+    for (int i = 0; i < 3; i++) gain[i] = ph[i] / s;
+    for (int i = 0; i < 3; i++) state[i] += gain[i] * innovation;
+    // p - k · h · p, which for a symmetric p is p - k · phᵀ
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) covariance[i][j] -= gain[i] * ph[j];
+}
+
+float PoseEkf::getX() const { return state[0]; }
+
+float PoseEkf::getY() const { return state[1]; }
+
+float PoseEkf::getTheta() const { return state[2]; }
+
+const Matrix3& PoseEkf::getCovariance() const { return covariance; }
+
+float PoseEkf::positionError() const {
+    // largest eigenvalue of the x-y block
+    const float a = covariance[0][0], b = covariance[0][1], d = covariance[1][1];
+    const float largest = (a + d) / 2 + std::sqrt((a - d) * (a - d) / 4 + b * b);
+    return std::sqrt(std::max(largest, 0.0f));
+}
+
+float PoseEkf::headingError() const { return std::sqrt(std::max(covariance[2][2], 0.0f)) * 180 / M_PI; }
+
+float PoseEkf::getSlip() const { return slip; }
+} // namespace kachow
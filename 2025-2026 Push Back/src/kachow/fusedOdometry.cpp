@@ -0,0 +1,157 @@
+#include "kachow/fusedOdometry.hpp"
+#include <cmath>
+#include <mutex>
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+FusedOdometry::FusedOdometry(Chassis* chassis, lemlib::TrackingWheel* horizontal, pros::Imu* imu, pros::Gps* gps,
+                             EkfSettings settings)
+    : chassis(chassis),
+      horizontal(horizontal),
+      imu(imu),
+      gps(gps),
+      settings(settings),
+      ekf(0, 0, settings) {}
+
+void FusedOdometry::start() {
+    if (task != nullptr) return;
+    // the geometry is read now rather than when constructed, so calibrated values loaded in initialize() are used
+    const lemlib::Drivetrain& drivetrain = chassis->getDrivetrain();
+    left = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter, -drivetrain.trackWidth / 2,
+                                     drivetrain.rpm);
+    right = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter, drivetrain.trackWidth / 2,
+                                      drivetrain.rpm);
+    ekf = PoseEkf(drivetrain.trackWidth, horizontal != nullptr ? horizontal->getOffset() : 0, settings);
+    const lemlib::Pose pose = chassis->getPose(true);
+    ekf.reset(pose.x, pose.y, pose.theta);
+    prevLeft = left->getDistanceTraveled();
+    prevRight = right->getDistanceTraveled();
+    prevLateral = horizontal != nullptr ? horizontal->getDistanceTraveled() : 0;
+    prevRotation = imu->get_rotation();
+    prevTime = pros::millis();
+    synced = true;
+    chassis->onPoseReset([this](lemlib::Pose pose) {
+        std::lock_guard lock(mutex);
+        resetPose = pose;
+        resetPending = true;
+    });
+    chassis->onPoseCorrection([this](const PoseCorrection& correction) {
+        // only absolute fixes are news to the filter, the rest just take back odometry errors it already allows for
+        if (correction.error <= 0) return;
+        std::lock_guard lock(mutex);
+        fix = correction;
+        fixPending = true;
+    });
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, 10);
+            const uint64_t start = pros::micros();
+            step(now);
+            const uint32_t time = pros::micros() - start;
+            if (time > maxStepTime) maxStepTime = time;
+        }
+    });
+}
+
+void FusedOdometry::setCorrectChassis(bool correct) { correctChassis = correct; }
+
+void FusedOdometry::setTractionMonitor(const TractionMonitor* monitor) { traction = monitor; }
+
+bool FusedOdometry::startRecording(const std::string& path) {
+    stopRecording();
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        lemlib::infoSink()->warn("fused odometry: cannot record to {}", path);
+        return false;
+    }
+    fprintf(file, "time,dt,left,right,lateral,headingChange,slip,fixX,fixY,fixError,gpsX,gpsY,gpsError,x,y,theta\n");
+    std::lock_guard lock(mutex);
+    recording = file;
+    return true;
+}
+
+void FusedOdometry::stopRecording() {
+    // held while closing too, so a step can't be halfway through writing to it
+    std::lock_guard lock(mutex);
+    if (recording != nullptr) fclose(recording);
+    recording = nullptr;
+}
+
+PoseEkf FusedOdometry::getEkf() const {
+    std::lock_guard lock(mutex);
+    return ekf;
+}
+
+uint32_t FusedOdometry::getMaxStepTime() const { return maxStepTime; }
+
+void FusedOdometry::step(uint32_t now) {
+    std::unique_lock lock(mutex);
+    if (resetPending) {
+        ekf.reset(resetPose.x, resetPose.y, resetPose.theta * M_PI / 180);
+        resetPending = false;
+        fixPending = false;
+    }
+    float fixX = NAN, fixY = NAN, fixError = NAN;
+    if (fixPending) {
+        // a wall only fixes the axis it faces, and only that one was moved
+        fixX = fix.x != 0 ? fix.pose.x : NAN;
+        fixY = fix.y != 0 ? fix.pose.y : NAN;
+        fixError = fix.error;
+        ekf.updatePosition(fixX, fixY, fixError);
+        fixPending = false;
+    }
+
+    const float leftDistance = left->getDistanceTraveled();
+    const float rightDistance = right->getDistanceTraveled();
+    const float lateral = horizontal != nullptr ? horizontal->getDistanceTraveled() : 0;
+    const float rotation = imu->get_rotation();
+    // a sensor that drops out reads PROS_ERR or infinity, and the IMU's rotation starts again from 0 after it
+    // recalibrates. Skip those steps and pick up from wherever the sensors are once they are back
+    const bool valid = std::isfinite(leftDistance) && std::isfinite(rightDistance) && std::isfinite(lateral) &&
+                       std::isfinite(rotation) && !imu->is_calibrating();
+    const OdometryStep step {leftDistance - prevLeft,
+                             rightDistance - prevRight,
+                             lateral - prevLateral,
+                             float((rotation - prevRotation) * M_PI / 180),
+                             (now - prevTime) / 1000.0f,
+                             traction != nullptr ? traction->getState().severity : 0};
+    prevTime = now;
+    if (valid && synced) ekf.predict(step);
+    synced = valid;
+    if (valid) {
+        prevLeft = leftDistance;
+        prevRight = rightDistance;
+        prevLateral = lateral;
+        prevRotation = rotation;
+    }
+
+    float gpsX = NAN, gpsY = NAN, gpsError = NAN;
+    if (gps != nullptr) {
+        const pros::gps_status_s_t status = gps->get_position_and_orientation();
+        const double error = gps->get_error();
+        // the GPS reports meters from the middle of the field
+        if (std::isfinite(error) && std::isfinite(status.x) && error > 0) {
+            gpsX = 72 + status.x * 39.37f;
+            gpsY = 72 + status.y * 39.37f;
+            gpsError = std::fmax(error * 39.37f, 0.5f);
+            ekf.updatePosition(gpsX, gpsY, gpsError);
+        }
+    }
+    const float x = ekf.getX(), y = ekf.getY();
+    lock.unlock();
+    if (correctChassis && gps != nullptr) {
+        const lemlib::Pose pose = chassis->getPose();
+        chassis->correctPose(x - pose.x, y - pose.y);
+    }
+
+    const lemlib::Pose pose = chassis->getPose();
+    lock.lock();
+    if (recording != nullptr) {
+        fprintf(recording, "%u,%.4f,%.4f,%.4f,%.4f,%.6f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f\n", now,
+                step.dt, step.left, step.right, step.lateral, step.headingChange, step.slip, fixX, fixY, fixError, gpsX,
+                gpsY, gpsError, pose.x, pose.y, pose.theta);
+    }
+}
+} // namespace kachow
@@ -0,0 +1,138 @@
+#include "kachow/gainSchedule.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+// index of the grid cell a value falls in and how far across it, clamped to the grid
+void locate(const std::vector<float>& breakpoints, float value, size_t& index, float& fraction) {
+    if (breakpoints.size() < 2 || value <= breakpoints.front()) {
+        index = 0;
+        fraction = 0;
+        return;
+    }
+    if (value >= breakpoints.back()) {
+        index = breakpoints.size() - 2;
+        fraction = 1;
+        return;
+    }
+    index = std::upper_bound(breakpoints.begin(), breakpoints.end(), value) - breakpoints.begin() - 1;
+    fraction = (value - breakpoints[index]) / (breakpoints[index + 1] - breakpoints[index]);
+}
+
+Gains mix(const Gains& a, const Gains& b, float fraction) {
+    return {a.kP + (b.kP - a.kP) * fraction, a.kI + (b.kI - a.kI) * fraction, a.kD + (b.kD - a.kD) * fraction};
+}
+} // namespace
+
+GainSchedule::GainSchedule(std::vector<float> errors, std::vector<float> velocities, std::vector<Gains> gains)
+    : errors(std::move(errors)),
+      velocities(std::move(velocities)),
+      gains(std::move(gains)) {
+    if (this->errors.empty()) this->errors.push_back(0);
+    if (this->velocities.empty()) this->velocities.push_back(0);
+    // a short table would read past the end, pad it with the last entry
+    const Gains fill = this->gains.empty() ? Gains {0, 0, 0} : this->gains.back();
+    this->gains.resize(this->errors.size() * this->velocities.size(), fill);
+}
+
+GainSchedule::GainSchedule(std::vector<float> errors, Gains gains)
+    : GainSchedule(std::move(errors), {0}, {gains}) {}
+
+Gains GainSchedule::lookup(float error, float velocity) const {
+    size_t e, v;
+    float ef, vf;
+    locate(errors, std::fabs(error), e, ef);
+    locate(velocities, std::fabs(velocity), v, vf);
+    const size_t columns = velocities.size();
+    const auto at = [&](size_t row, size_t column) {
+        return gains[std::min(row, errors.size() - 1) * columns + std::min(column, columns - 1)];
+    };
+    return mix(mix(at(e, v), at(e, v + 1), vf), mix(at(e + 1, v), at(e + 1, v + 1), vf), ef);
+}
+
+size_t GainSchedule::band(float error) const {
+    return std::lower_bound(errors.begin(), errors.end(), std::fabs(error)) - errors.begin();
+}
+
+size_t GainSchedule::bands() const { return errors.size() + 1; }
+
+void GainSchedule::fill(Gains gains) { std::fill(this->gains.begin(), this->gains.end(), gains); }
+
+const std::vector<float>& GainSchedule::getErrors() const { return errors; }
+
+ScheduledPID::ScheduledPID(const GainSchedule& schedule, float windupRange, bool signFlipReset)
+    : schedule(schedule),
+      windupRange(windupRange),
+      signFlipReset(signFlipReset) {}
+
+float ScheduledPID::update(float error, float velocity) {
+    const Gains gains = schedule.lookup(error, velocity);
+    integral += error;
+    if (signFlipReset && !first && std::signbit(error) != std::signbit(prevError)) integral = 0;
+    if (windupRange != 0 && std::fabs(error) > windupRange) integral = 0;
+    const float derivative = first ? 0 : error - prevError;
+    prevError = error;
+    first = false;
+    return error * gains.kP + integral * gains.kI + derivative * gains.kD;
+}
+
+void ScheduledPID::reset() {
+    integral = 0;
+    prevError = 0;
+    first = true;
+}
+
+TurnMetrics::TurnMetrics(float settleRange)
+    : settleRange(settleRange) {}
+
+void TurnMetrics::start(float error, uint32_t now) {
+    result = {std::fabs(error), 0, 0, error, 0};
+    startTime = now;
+    settledSince = 0;
+    settled = false;
+    direction = error < 0 ? -1 : 1;
+}
+
+void TurnMetrics::update(float error, float velocity, uint32_t now) {
+    result.finalError = error;
+    result.peakVelocity = std::max(result.peakVelocity, std::fabs(velocity));
+    // past the target the error has the opposite sign to where it started
+    result.overshoot = std::max(result.overshoot, -error * direction);
+    if (std::fabs(error) <= settleRange) {
+        if (!settled) settledSince = now;
+        settled = true;
+    } else {
+        settled = false;
+    }
+    result.settleTime = (settled ? settledSince : now) - startTime;
+}
+
+TurnResult TurnMetrics::finish() const { return result; }
+
+TuningLog::TuningLog(size_t bands)
+    : counts(bands, 0),
+      totals(bands, TurnResult {}) {}
+
+void TuningLog::record(size_t band, const TurnResult& result) {
+    if (band >= counts.size()) return;
+    counts[band]++;
+    TurnResult& total = totals[band];
+    total.turn += result.turn;
+    total.settleTime += result.settleTime;
+    total.overshoot += result.overshoot;
+    total.finalError += std::fabs(result.finalError);
+    total.peakVelocity += result.peakVelocity;
+}
+
+size_t TuningLog::count(size_t band) const { return band < counts.size() ? counts[band] : 0; }
+
+TurnResult TuningLog::average(size_t band) const {
+    const size_t n = count(band);
+    if (n == 0) return {};
+    const TurnResult& total = totals[band];
+    return {total.turn / n, uint32_t(total.settleTime / n), total.overshoot / n, total.finalError / n,
+            total.peakVelocity / n};
+}
+} // namespace kachow
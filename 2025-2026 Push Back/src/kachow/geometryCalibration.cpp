@@ -0,0 +1,84 @@
+#include "kachow/geometryCalibration.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+GeometrySolver::GeometrySolver(OdometryGeometry current)
+    : current(current) {}
+
+void GeometrySolver::addSpin(const SpinMeasurement& spin) {
+    // the left wheels roll forwards trackWidth / 2 per radian of clockwise turn and the right ones backwards, and the
+    // tracking wheel reads spinRoll, -offset per radian
+    spinWidth += (spin.left - spin.right) * spin.rotation;
+    spinOffset -= spin.lateral * spin.rotation;
+    spinSquares += spin.rotation * spin.rotation;
+    if (spin.rotation != 0) {
+        const double width = (spin.left - spin.right) / spin.rotation;
+        widthSum += width;
+        widthSquares += width * width;
+        spins++;
+    }
+}
+
+void GeometrySolver::addStraight(const StraightMeasurement& straight, float distance) {
+    const float measured = (straight.left + straight.right) / 2;
+    straightTrue += distance * measured;
+    straightSquares += measured * measured;
+}
+
+void GeometrySolver::addSlide(float lateral, float distance) {
+    slideTrue += distance * lateral;
+    slideSquares += lateral * lateral;
+}
+
+OdometryGeometry GeometrySolver::solve() const {
+    OdometryGeometry result = current;
+    result.driveDiameter = current.driveDiameter * driveScale();
+    result.trackingDiameter = current.trackingDiameter * trackingScale();
+    if (spinSquares > 0) {
+        result.trackWidth = spinWidth / spinSquares * driveScale();
+        result.trackingOffset = spinOffset / spinSquares * trackingScale();
+    }
+    return result;
+}
+
+float GeometrySolver::spinSpread() const {
+    if (spins < 2) return 0;
+    const double mean = widthSum / spins;
+    const double variance = (widthSquares - spins * mean * mean) / (spins - 1);
+    return std::sqrt(std::max(variance, 0.0)) * driveScale();
+}
+
+bool GeometrySolver::isSlideBackwards() const { return slideSquares > 0 && slideTrue <= 0; }
+
+int GeometrySolver::getSpins() const { return spins; }
+
+// a scale that isn't positive would make a negative diameter, so it is left alone
+float GeometrySolver::driveScale() const { return straightTrue > 0 ? straightTrue / straightSquares : 1; }
+
+float GeometrySolver::trackingScale() const { return slideTrue > 0 ? slideTrue / slideSquares : 1; }
+
+float spinRoll(float offset, float rotation) { return -offset * rotation; }
+
+float spinTicksPerDegree(float diameter, float offset) {
+    // 36000 centidegrees to every pi * diameter inches the wheel rolls
+    return spinRoll(offset, M_PI / 180) * 36000 / (M_PI * diameter);
+}
+
+void saveGeometry(Config& config, const std::string& prefix, const OdometryGeometry& geometry) {
+    config.set(prefix + ".trackWidth", geometry.trackWidth);
+    config.set(prefix + ".driveDiameter", geometry.driveDiameter);
+    config.set(prefix + ".trackingDiameter", geometry.trackingDiameter);
+    config.set(prefix + ".trackingOffset", geometry.trackingOffset);
+}
+
+bool loadGeometry(const Config& config, const std::string& prefix, OdometryGeometry& geometry) {
+    for (const char* key : {".trackWidth", ".driveDiameter", ".trackingDiameter", ".trackingOffset"}) {
+        if (!config.has(prefix + key)) return false;
+    }
+    geometry = {config.getFloat(prefix + ".trackWidth"), config.getFloat(prefix + ".driveDiameter"),
+                config.getFloat(prefix + ".trackingDiameter"), config.getFloat(prefix + ".trackingOffset")};
+    return true;
+}
+} // namespace kachow
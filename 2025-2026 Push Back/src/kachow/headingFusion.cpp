@@ -0,0 +1,73 @@
+#include "kachow/headingFusion.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+HeadingFusion::HeadingFusion(HeadingFusionSettings settings)
+    : settings(settings) {}
+
+float HeadingFusion::update(const HeadingSample& sample) {
+    if (sample.dt <= 0) return 0;
+    runTime += sample.dt;
+    if (std::isfinite(sample.first)) first.heading += sample.first;
+    if (std::isfinite(sample.second)) second.heading += sample.second;
+
+    bool useFirst = std::isfinite(sample.first) && !first.dropped;
+    bool useSecond = std::isfinite(sample.second) && !second.dropped;
+    const float firstRate = useFirst ? sample.first / sample.dt - first.bias : 0;
+    const float secondRate = useSecond ? sample.second / sample.dt - second.bias : 0;
+
+    // two sensors can't vote, so the odd one out is whichever is further from how fast the robot was just turning
+    if (useFirst && useSecond && std::fabs(firstRate - secondRate) > settings.outlierRate) {
+        const bool firstOdd = std::fabs(firstRate - prevRate) > std::fabs(secondRate - prevRate);
+        Source& odd = firstOdd ? first : second;
+        if (firstOdd) useFirst = false;
+        else useSecond = false;
+        if (++odd.outliers >= settings.maxOutliers) odd.dropped = true;
+        outliers++;
+    }
+    if (useFirst) first.outliers = 0;
+    if (useSecond) second.outliers = 0;
+
+    const int sources = useFirst + useSecond;
+    const float rate = sources > 0 ? ((useFirst ? firstRate : 0) + (useSecond ? secondRate : 0)) / sources : 0;
+    if (sample.wheelsStill && sources > 0 && std::fabs(rate) < settings.stillRate) stillFor += sample.dt;
+    else stillFor = 0;
+
+    float change = rate * sample.dt;
+    if (isStill()) {
+        // anything read now is bias
+        const float gain = std::min(sample.dt / settings.biasTime, 1.0f);
+        if (useFirst) {
+            first.bias = std::clamp(first.bias + firstRate * gain, -settings.maxBias, settings.maxBias);
+        }
+        if (useSecond) {
+            second.bias = std::clamp(second.bias + secondRate * gain, -settings.maxBias, settings.maxBias);
+        }
+        stillTime += sample.dt;
+        change = 0;
+    }
+    prevRate = change / sample.dt;
+    heading += change;
+    return change;
+}
+
+float HeadingFusion::getHeading() const { return heading; }
+
+void HeadingFusion::setHeading(float heading) {
+    const float shift = heading - this->heading;
+    this->heading = heading;
+    first.heading += shift;
+    second.heading += shift;
+}
+
+bool HeadingFusion::isStill() const { return stillFor >= settings.settleTime; }
+
+DriftReport HeadingFusion::getReport() const {
+    return {runTime,  stillTime,     first.heading - heading, second.heading - heading, first.bias, second.bias,
+            outliers, first.dropped, second.dropped};
+}
+
+void HeadingFusion::reset() { *this = HeadingFusion(settings); }
+} // namespace kachow
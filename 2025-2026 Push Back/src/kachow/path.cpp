@@ -0,0 +1,31 @@
+#include "kachow/path.hpp"
+#include <cstring>
+
+namespace kachow {
+
+PathView::PathView(const asset& file)
+    : PathView(file.buf, file.size) {}
+
+PathView::PathView(const uint8_t* buffer, size_t size) {
+    if (buffer == nullptr || size < sizeof(PathHeader)) return;
+    PathHeader header;
+    memcpy(&header, buffer, sizeof(header));
+    if (header.magic != PATH_MAGIC || header.version != PATH_VERSION) return;
+    if (size < sizeof(PathHeader) + header.count * sizeof(PathPoint)) return;
+    points = buffer + sizeof(PathHeader);
+    count = header.count;
+    pathLength = header.length;
+}
+
+bool PathView::isValid() const { return points != nullptr; }
+
+size_t PathView::size() const { return count; }
+
+float PathView::length() const { return pathLength; }
+
+PathPoint PathView::operator[](size_t index) const {
+    PathPoint point;
+    memcpy(&point, points + index * sizeof(PathPoint), sizeof(point));
+    return point;
+}
+} // namespace kachow
@@ -0,0 +1,203 @@
+#include "kachow/purePursuit.hpp"
+#include <cmath>
+
+namespace kachow {
+
+PurePursuit::PurePursuit(const PathView& path, float lookahead, float window)
+    : path(path),
+      lookahead(lookahead),
+      window(window > 0 ? window : 2 * lookahead) {
+    reset();
+}
+
+void PurePursuit::reset() {
+    closestIndex = 0;
+    lookaheadIndex = 0;
+    distanceTraveled = 0;
+    if (path.size() == 0) return;
+    const PathPoint first = path[0];
+    lookaheadX = first.x;
+    lookaheadY = first.y;
+}
+
+float PurePursuit::getDistanceTraveled() const { return distanceTraveled; }
+
+PursuitCommand PurePursuit::update(float x, float y, float theta) {
+    if (path.size() < 2) return {0, 0, 0, true};
+    const size_t closest = findClosest(x, y);
+    const PathPoint closestPoint = path[closest];
+    distanceTraveled = closestPoint.distance;
+    // the last point is the only one with no speed
+    if (closest == path.size() - 1 || closestPoint.velocity == 0) return {0, 0, closest, true};
+
+    findLookahead(x, y, closest);
+    return {arcCurvature(x, y, theta, lookaheadX, lookaheadY), closestPoint.velocity, closest, false};
+}
+
+float PurePursuit::curvatureFrom(float x, float y, float theta) const {
+    return arcCurvature(x, y, theta, lookaheadX, lookaheadY);
+}
+
+size_t PurePursuit::findClosest(float x, float y) {
+    // the robot never goes back along the path, so start from last time's closest point
+    const float end = path[closestIndex].distance + window;
+    float closestDist = INFINITY;
+    size_t closest = closestIndex;
+    for (size_t i = closestIndex; i < path.size(); i++) {
+        const PathPoint point = path[i];
+        if (point.distance > end) break;
+        const float dist = (point.x - x) * (point.x - x) + (point.y - y) * (point.y - y);
+        if (dist < closestDist) {
+            closestDist = dist;
+            closest = i;
+        }
+    }
+    closestIndex = closest;
+    return closest;
+}
+
+void PurePursuit::findLookahead(float x, float y, size_t closest) {
+    // only intersections past both the closest point and the last lookahead point count, so it never moves backwards
+    const size_t start = closest > lookaheadIndex ? closest : lookaheadIndex;
+    const float end = path[closest].distance + window;
+    for (size_t i = start; i + 1 < path.size(); i++) {
+        const PathPoint a = path[i];
+        if (a.distance > end) break;
+        const PathPoint b = path[i + 1];
+        const float t = circleIntersect(a.x, a.y, b.x, b.y, x, y, lookahead);
+        if (t != -1) {
+            lookaheadX = a.x + (b.x - a.x) * t;
+            lookaheadY = a.y + (b.y - a.y) * t;
+            lookaheadIndex = i;
+            return;
+        }
+    }
+}
+
+SplinePursuit::SplinePursuit(const SplinePath& path, float lookahead, float window)
+    : path(path),
+      lookahead(lookahead),
+      window(window > 0 ? window : 2 * lookahead) {
+    reset();
+}
+
+void SplinePursuit::reset() {
+    closestDistance = 0;
+    lookaheadDistance = 0;
+    if (path.isValid()) lookaheadPoint = path.at(0);
+}
+
+float SplinePursuit::getDistanceTraveled() const { return closestDistance; }
+
+PursuitCommand SplinePursuit::update(float x, float y, float theta) {
+    // closer than this to the end counts as finished, the speed tapers towards it
+    constexpr float endTolerance = 0.5;
+    if (!path.isValid()) return {0, 0, 0, true};
+    const PathPoint closestPoint = path.at(findClosest(x, y));
+    const size_t segment = path.segmentAt(closestDistance);
+    if (path.length() - closestDistance < endTolerance) return {0, 0, segment, true};
+
+    findLookahead(x, y);
+    return {arcCurvature(x, y, theta, lookaheadPoint.x, lookaheadPoint.y), closestPoint.velocity, segment, false};
+}
+
+float SplinePursuit::curvatureFrom(float x, float y, float theta) const {
+    return arcCurvature(x, y, theta, lookaheadPoint.x, lookaheadPoint.y);
+}
+
+float SplinePursuit::findClosest(float x, float y) {
+    // coarse search along the window, then narrow down around the best step. Never goes back along the path
+    constexpr float step = 1;
+    const auto distSquared = [&](float distance) {
+        const PathPoint point = path.at(distance);
+        return (point.x - x) * (point.x - x) + (point.y - y) * (point.y - y);
+    };
+    const float end = std::fmin(closestDistance + window, path.length());
+    float best = closestDistance;
+    float bestDist = distSquared(best);
+    for (float distance = closestDistance + step; distance <= end; distance += step) {
+        const float dist = distSquared(distance);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = distance;
+        }
+    }
+    if (end - best < step) {
+        const float dist = distSquared(end);
+        if (dist < bestDist) best = end;
+    }
+    float low = std::fmax(best - step, closestDistance);
+    float high = std::fmin(best + step, path.length());
+    for (int i = 0; i < 12; i++) {
+        const float a = low + (high - low) / 3;
+        const float b = high - (high - low) / 3;
+        if (distSquared(a) < distSquared(b)) high = b;
+        else low = a;
+    }
+    closestDistance = (low + high) / 2;
+    return closestDistance;
+}
+
+void SplinePursuit::findLookahead(float x, float y) {
+    // first point past both the closest point and the last lookahead point that is a lookahead distance away
+    constexpr float step = 1;
+    const auto outside = [&](float distance) {
+        const PathPoint point = path.at(distance);
+        return std::hypot(point.x - x, point.y - y) >= lookahead;
+    };
+    const float end = std::fmin(closestDistance + window, path.length());
+    float inside = std::fmax(closestDistance, lookaheadDistance);
+    if (inside >= end) {
+        lookaheadDistance = end;
+        lookaheadPoint = path.at(end);
+        return;
+    }
+    float distance = inside;
+    while (true) {
+        distance = std::fmin(distance + step, end);
+        if (outside(distance)) break;
+        inside = distance;
+        // the end of the path is inside the circle, aim straight at it
+        if (distance >= end) {
+            lookaheadDistance = end;
+            lookaheadPoint = path.at(end);
+            return;
+        }
+    }
+    for (int i = 0; i < 10; i++) {
+        const float middle = (inside + distance) / 2;
+        if (outside(middle)) distance = middle;
+        else inside = middle;
+    }
+    lookaheadDistance = distance;
+    lookaheadPoint = path.at(distance);
+}
+
+float circleIntersect(float ax, float ay, float bx, float by, float cx, float cy, float radius) {
+    const float dx = bx - ax;
+    const float dy = by - ay;
+    const float fx = ax - cx;
+    const float fy = ay - cy;
+    const float a = dx * dx + dy * dy;
+    const float b = 2 * (fx * dx + fy * dy);
+    const float c = fx * fx + fy * fy - radius * radius;
+    float discriminant = b * b - 4 * a * c;
+    if (a == 0 || discriminant < 0) return -1;
+    discriminant = std::sqrt(discriminant);
+    const float t1 = (-b - discriminant) / (2 * a);
+    const float t2 = (-b + discriminant) / (2 * a);
+    if (t2 >= 0 && t2 <= 1) return t2;
+    if (t1 >= 0 && t1 <= 1) return t1;
+    return -1;
+}
+
+float arcCurvature(float x, float y, float theta, float targetX, float targetY) {
+    const float dx = targetX - x;
+    const float dy = targetY - y;
+    const float distSquared = dx * dx + dy * dy;
+    if (distSquared == 0) return 0;
+    // sideways offset of the target in the robot's frame, left is positive
+    const float left = -std::sin(theta) * dx + std::cos(theta) * dy;
+    return 2 * left / distSquared;
+}
+} // namespace kachow
@@ -0,0 +1,69 @@
+#include "kachow/relayTuner.hpp"
+#include <cmath>
+
+namespace kachow {
+
+RelayTuner::RelayTuner(float relay, float hysteresis, int cycles, int settleCycles)
+    : relay(relay),
+      hysteresis(hysteresis),
+      cycles(cycles),
+      settleCycles(settleCycles),
+      high(-INFINITY),
+      low(INFINITY) {}
+
+float RelayTuner::update(float error, uint32_t now) {
+    if (!started) {
+        sign = error < 0 ? -1 : 1;
+        started = true;
+    }
+    high = std::fmax(high, error);
+    low = std::fmin(low, error);
+
+    if (sign > 0 && error < -hysteresis) {
+        sign = -1;
+    } else if (sign < 0 && error > hysteresis) {
+        sign = 1;
+        // one full cycle runs from one switch on to the next
+        rises++;
+        if (rises > settleCycles + 1 && !done()) {
+            periodSum += now - lastRise;
+            amplitudeSum += (high - low) / 2;
+            measured++;
+        }
+        lastRise = now;
+        high = -INFINITY;
+        low = INFINITY;
+    }
+    return sign * relay;
+}
+
+bool RelayTuner::done() const { return measured >= cycles; }
+
+RelayResult RelayTuner::result() const {
+    if (measured == 0) return {false, 0, 0, 0};
+    const float amplitude = amplitudeSum / measured;
+    // describing function of a relay with hysteresis
+    if (amplitude <= hysteresis) return {false, 0, 0, amplitude};
+    const float ultimateGain = 4 * relay / (M_PI * std::sqrt(amplitude * amplitude - hysteresis * hysteresis));
+    return {done(), ultimateGain, periodSum / measured / 1000, amplitude};
+}
+
+Gains relayGains(const RelayResult& result, TuningRule rule, float period) {
+    if (!result.valid || period <= 0) return {0, 0, 0};
+    const float ku = result.ultimateGain;
+    const float tu = result.ultimatePeriod;
+    // proportional gain, integral time and derivative time. An integral time of 0 means no integral
+    struct {
+            float kP, ti, td;
+    } r;
+    switch (rule) {
+        case TuningRule::ZIEGLER_NICHOLS: r = {0.6f * ku, tu / 2, tu / 8}; break;
+        case TuningRule::PESSEN_INTEGRAL: r = {0.7f * ku, 0.4f * tu, 0.15f * tu}; break;
+        case TuningRule::PD: r = {0.8f * ku, 0, tu / 8}; break;
+        case TuningRule::SOME_OVERSHOOT: r = {ku / 3, tu / 2, tu / 3}; break;
+        case TuningRule::NO_OVERSHOOT: r = {0.2f * ku, tu / 2, tu / 3}; break;
+        default: return {0, 0, 0};
+    }
+    return {r.kP, r.ti > 0 ? r.kP * period / r.ti : 0, r.kP * r.td / period};
+}
+} // namespace kachow
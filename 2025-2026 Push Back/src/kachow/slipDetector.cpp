@@ -0,0 +1,69 @@
+#include "kachow/slipDetector.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+SlipDetector::SlipDetector(float trackWidth, float trackingOffset, SlipSettings settings)
+    : trackWidth(trackWidth),
+      trackingOffset(trackingOffset),
+      settings(settings) {}
+
+void SlipDetector::reset() {
+    state = {false, false, false, 0, 0, 0};
+    accelBias = 0;
+    slipTime = 0;
+}
+
+const SlipState& SlipDetector::update(const TractionSample& sample) {
+    if (sample.dt <= 0) return state;
+    const float wheelVelocity = (sample.leftVelocity + sample.rightVelocity) / 2;
+    const float turnRate = sample.turnRate * 180 / M_PI;
+
+    // still: the accelerometer should read nothing, so whatever it reads is bias
+    const bool still = std::fabs(sample.leftVelocity) < settings.stillSpeed &&
+                       std::fabs(sample.rightVelocity) < settings.stillSpeed;
+    if (still) {
+        accelBias += (sample.forwardAccel - accelBias) * std::min(sample.dt / 1.0f, 1.0f);
+        state.groundVelocity = 0;
+    } else {
+        state.groundVelocity += (sample.forwardAccel - accelBias) * sample.dt;
+    }
+
+    // forward slip, with hysteresis so it does not flicker at the threshold
+    state.forwardError = wheelVelocity - state.groundVelocity;
+    const float error = std::fabs(state.forwardError);
+    if (state.slipping) {
+        slipTime += sample.dt;
+        if (error < settings.slipSpeed / 2 || slipTime > settings.maxSlipTime) state.slipping = false;
+    } else if (error > settings.slipSpeed) {
+        state.slipping = true;
+        slipTime = 0;
+    }
+    // only follow the wheels while they grip, and catch up at once after giving up on a long slip
+    if (!state.slipping) {
+        const float blend = slipTime > settings.maxSlipTime ? 1 : std::min(sample.dt / settings.blendTime, 1.0f);
+        state.groundVelocity += (wheelVelocity - state.groundVelocity) * blend;
+        slipTime = 0;
+    }
+
+    // turning slip
+    const float wheelTurnRate = (sample.leftVelocity - sample.rightVelocity) / trackWidth * 180 / M_PI;
+    const float excessTurn = std::fabs(wheelTurnRate - turnRate) - settings.scrubAllowance * std::fabs(turnRate);
+    state.turnSlipping = excessTurn > settings.turnSlipRate;
+
+    // the tracking wheel also reads -offset per radian of turn without the robot sliding (see spinRoll)
+    const float slide = sample.lateralVelocity + trackingOffset * sample.turnRate;
+    state.sliding = std::fabs(slide) > settings.slideSpeed;
+
+    state.severity = 0;
+    if (state.slipping) state.severity = std::clamp(error / (2 * settings.slipSpeed), 0.0f, 1.0f);
+    if (state.turnSlipping)
+        state.severity = std::max(state.severity, std::clamp(excessTurn / (2 * settings.turnSlipRate), 0.0f, 1.0f));
+    return state;
+}
+
+const SlipState& SlipDetector::getState() const { return state; }
+
+float SlipDetector::getAccelBias() const { return accelBias; }
+} // namespace kachow
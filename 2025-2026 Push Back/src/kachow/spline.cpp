@@ -0,0 +1,72 @@
+#include "kachow/spline.hpp"
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+float polynomial(const std::array<float, 6>& c, float t) {
+    return c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+}
+
+float polynomialDerivative(const std::array<float, 6>& c, float t) {
+    return c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5])));
+}
+
+float polynomialSecondDerivative(const std::array<float, 6>& c, float t) {
+    return 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5]));
+}
+
+// power basis coefficients of the quintic Hermite basis for one axis
+std::array<float, 6> hermiteCoefficients(float p0, float v0, float a0, float p1, float v1, float a1) {
+    return {p0,
+            v0,
+            a0 / 2,
+            -10 * p0 - 6 * v0 - 1.5f * a0 + 0.5f * a1 - 4 * v1 + 10 * p1,
+            15 * p0 + 8 * v0 + 1.5f * a0 - a1 + 7 * v1 - 15 * p1,
+            -6 * p0 - 3 * v0 - 0.5f * a0 + 0.5f * a1 - 3 * v1 + 6 * p1};
+}
+
+std::array<float, 6> bezierCoefficients(float p0, float p1, float p2, float p3) {
+    return {p0, 3 * (p1 - p0), 3 * (p0 - 2 * p1 + p2), -p0 + 3 * p1 - 3 * p2 + p3, 0, 0};
+}
+} // namespace
+
+SplineSegment SplineSegment::hermite(const SplineKnot& start, const SplineKnot& end) {
+    return {hermiteCoefficients(start.x, start.dx, start.ddx, end.x, end.dx, end.ddx),
+            hermiteCoefficients(start.y, start.dy, start.ddy, end.y, end.dy, end.ddy)};
+}
+
+SplineSegment SplineSegment::bezier(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3) {
+    return {bezierCoefficients(x0, x1, x2, x3), bezierCoefficients(y0, y1, y2, y3)};
+}
+
+void SplineSegment::position(float t, float& x, float& y) const {
+    x = polynomial(cx, t);
+    y = polynomial(cy, t);
+}
+
+void SplineSegment::derivative(float t, float& dx, float& dy) const {
+    dx = polynomialDerivative(cx, t);
+    dy = polynomialDerivative(cy, t);
+}
+
+void SplineSegment::secondDerivative(float t, float& ddx, float& ddy) const {
+    ddx = polynomialSecondDerivative(cx, t);
+    ddy = polynomialSecondDerivative(cy, t);
+}
+
+float SplineSegment::heading(float t) const {
+    float dx, dy;
+    derivative(t, dx, dy);
+    return std::atan2(dy, dx);
+}
+
+float SplineSegment::curvature(float t) const {
+    float dx, dy, ddx, ddy;
+    derivative(t, dx, dy);
+    secondDerivative(t, ddx, ddy);
+    const float speedSquared = dx * dx + dy * dy;
+    if (speedSquared == 0) return 0;
+    return (dx * ddy - dy * ddx) / (speedSquared * std::sqrt(speedSquared));
+}
+} // namespace kachow
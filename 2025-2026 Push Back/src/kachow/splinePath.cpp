@@ -0,0 +1,108 @@
+#include "kachow/splinePath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace kachow {
+
+SplinePath::SplinePath(const asset& file)
+    : SplinePath(file.buf, file.size) {}
+
+SplinePath::SplinePath(const uint8_t* buffer, size_t size) {
+    if (buffer == nullptr || size < sizeof(PathHeader)) return;
+    PathHeader header;
+    memcpy(&header, buffer, sizeof(header));
+    if (header.magic != SPLINE_PATH_MAGIC || header.version != SPLINE_PATH_VERSION || header.count == 0) return;
+    if (size < sizeof(PathHeader) + header.count * sizeof(SplineRecord)) return;
+    records = buffer + sizeof(PathHeader);
+    count = header.count;
+
+    segmentStart.reserve(count + 1);
+    arcLengths.reserve(count * ARC_LENGTH_STEPS);
+    float distance = 0;
+    for (size_t i = 0; i < count; i++) {
+        segmentStart.push_back(distance);
+        const SplineSegment segment = (*this)[i].segment;
+        float length = 0;
+        for (size_t step = 0; step < ARC_LENGTH_STEPS; step++) {
+            length += arcLength(segment, float(step) / ARC_LENGTH_STEPS, float(step + 1) / ARC_LENGTH_STEPS);
+            arcLengths.push_back(length);
+        }
+        distance += length;
+    }
+    segmentStart.push_back(distance);
+    pathLength = distance;
+}
+
+bool SplinePath::isValid() const { return records != nullptr; }
+
+size_t SplinePath::size() const { return count; }
+
+float SplinePath::length() const { return pathLength; }
+
+SplineRecord SplinePath::operator[](size_t index) const {
+    SplineRecord record;
+    memcpy(&record, records + index * sizeof(SplineRecord), sizeof(record));
+    return record;
+}
+
+float SplinePath::parameter(size_t segment, float distance) const {
+    const float* lengths = arcLengths.data() + segment * ARC_LENGTH_STEPS;
+    const size_t step = std::lower_bound(lengths, lengths + ARC_LENGTH_STEPS, distance) - lengths;
+    if (step >= ARC_LENGTH_STEPS) return 1;
+    const float before = step == 0 ? 0 : lengths[step - 1];
+    const float span = lengths[step] - before;
+    const float t0 = float(step) / ARC_LENGTH_STEPS;
+    float t = t0 + (span > 0 ? (distance - before) / span : 0) / ARC_LENGTH_STEPS;
+    // one Newton step on the leftover error, arc length is close to linear in t over one step
+    float dx, dy;
+    const SplineSegment curve = (*this)[segment].segment;
+    curve.derivative(t, dx, dy);
+    const float speed = std::hypot(dx, dy);
+    if (speed > 0) t -= (before + arcLength(curve, t0, t) - distance) / speed;
+    return std::clamp(t, 0.0f, 1.0f);
+}
+
+PathPoint SplinePath::at(float distance) const {
+    distance = std::clamp(distance, 0.0f, pathLength);
+    const size_t segment = segmentAt(distance);
+    const SplineRecord record = (*this)[segment];
+    const float local = distance - segmentStart[segment];
+    const float t = parameter(segment, local);
+
+    PathPoint point;
+    record.segment.position(t, point.x, point.y);
+    point.heading = record.segment.heading(t);
+    point.curvature = record.segment.curvature(t);
+    point.distance = distance;
+    // speeds are evenly spaced by distance along the segment
+    const float segmentLength = segmentStart[segment + 1] - segmentStart[segment];
+    const float index = segmentLength > 0 ? local / segmentLength * (SPLINE_VELOCITY_SAMPLES - 1) : 0;
+    const size_t low = std::min(size_t(index), SPLINE_VELOCITY_SAMPLES - 2);
+    const float fraction = index - low;
+    point.velocity = record.velocity[low] + (record.velocity[low + 1] - record.velocity[low]) * fraction;
+    return point;
+}
+
+size_t SplinePath::segmentAt(float distance) const {
+    if (count == 0) return 0;
+    // last segment that starts at or before the distance
+    const auto after = std::upper_bound(segmentStart.begin(), segmentStart.begin() + count, distance);
+    return after == segmentStart.begin() ? 0 : after - segmentStart.begin() - 1;
+}
+
+float arcLength(const SplineSegment& segment, float from, float to) {
+    // 5 point Gauss-Legendre quadrature of the speed along the segment
+    constexpr float nodes[5] = {0, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f};
+    constexpr float weights[5] = {0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f};
+    const float half = (to - from) / 2;
+    const float middle = (to + from) / 2;
+    float length = 0;
+    for (int i = 0; i < 5; i++) {
+        float dx, dy;
+        segment.derivative(middle + half * nodes[i], dx, dy);
+        length += weights[i] * std::hypot(dx, dy);
+    }
+    return length * half;
+}
+} // namespace kachow
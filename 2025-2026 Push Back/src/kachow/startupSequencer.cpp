@@ -0,0 +1,70 @@
+#include "kachow/startupSequencer.hpp"
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+int StartupSequencer::add(const std::string& name, std::function<void()> step, std::vector<int> after) {
+    steps.push_back(std::make_unique<Step>());
+    steps.back()->name = name;
+    steps.back()->run = std::move(step);
+    steps.back()->after = std::move(after);
+    return count() - 1;
+}
+
+void StartupSequencer::start() {
+    if (started) return;
+    started = true;
+    startTime = pros::millis();
+    if (steps.empty()) readyTime = 1;
+    for (const std::unique_ptr<Step>& pointer : steps) {
+        Step* step = pointer.get();
+        pros::Task task([this, step] {
+            for (const int i : step->after) {
+                while (!steps[i]->done) pros::delay(5);
+            }
+            const uint32_t begin = pros::millis();
+            step->run();
+            step->duration = pros::millis() - begin;
+            step->done = true;
+            if (++done < count()) return;
+            // never 0, which means not ready yet
+            readyTime = std::max(pros::millis() - startTime, uint32_t(1));
+            logTimes();
+        });
+    }
+}
+
+bool StartupSequencer::isReady() const { return readyTime != 0; }
+
+bool StartupSequencer::waitUntilReady(int timeout) const {
+    const uint32_t start = pros::millis();
+    while (!isReady()) {
+        if (timeout >= 0 && pros::millis() - start >= uint32_t(timeout)) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+
+int StartupSequencer::finished() const { return done; }
+
+int StartupSequencer::count() const { return steps.size(); }
+
+std::string StartupSequencer::running() const {
+    for (const std::unique_ptr<Step>& step : steps) {
+        if (!step->done) return step->name;
+    }
+    return "";
+}
+
+uint32_t StartupSequencer::getReadyTime() const { return readyTime; }
+
+void StartupSequencer::logTimes() const {
+    std::string times;
+    for (const std::unique_ptr<Step>& step : steps) {
+        times += (times.empty() ? "" : ", ") + step->name + " " + std::to_string(step->duration) + "ms";
+    }
+    lemlib::infoSink()->info("ready {}ms after start up: {}", readyTime.load(), times);
+}
+} // namespace kachow
@@ -0,0 +1,40 @@
+#include "kachow/stepResponse.hpp"
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+// first time the normalized response reaches level, interpolated between samples. Negative if it never does
+float crossing(const std::vector<float>& normalized, float level, float dt, float time) {
+    for (size_t i = 1; i < normalized.size(); i++) {
+        if (normalized[i] < level) continue;
+        const float fraction = (level - normalized[i - 1]) / (normalized[i] - normalized[i - 1]);
+        return time + (i - 1 + fraction) * dt;
+    }
+    return -1;
+}
+} // namespace
+
+StepResponse fitStepResponse(const std::vector<float>& samples, float dt, float time) {
+    const StepResponse invalid {false, 0, 0, 0};
+    if (samples.size() < 10) return invalid;
+
+    const size_t tail = samples.size() / 5;
+    float finalValue = 0;
+    for (size_t i = samples.size() - tail; i < samples.size(); i++) finalValue += samples[i];
+    finalValue /= tail;
+    const float start = samples[0];
+    if (std::fabs(finalValue - start) < 1e-6) return invalid;
+
+    std::vector<float> normalized(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) normalized[i] = (samples[i] - start) / (finalValue - start);
+    // the first sample is the starting level, so a crossing is always between two samples
+    normalized[0] = 0;
+
+    const float t28 = crossing(normalized, 0.283, dt, time);
+    const float t63 = crossing(normalized, 0.632, dt, time);
+    if (t28 < 0 || t63 < 0) return invalid;
+    const float timeConstant = 1.5f * (t63 - t28);
+    return {true, std::fmax(t63 - timeConstant, 0.0f), timeConstant, finalValue};
+}
+} // namespace kachow
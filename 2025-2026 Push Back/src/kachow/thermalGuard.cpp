@@ -0,0 +1,160 @@
+#include "kachow/thermalGuard.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include "pros/error.h"
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+namespace {
+// the V5 motor's own default, for when no motor answers
+constexpr std::int32_t DEFAULT_CURRENT_LIMIT = 2500;
+
+// from the first motor that answers
+std::int32_t currentLimit(const std::vector<pros::MotorGroup*>& groups) {
+    for (pros::MotorGroup* motors : groups) {
+        for (const std::int32_t limit : motors->get_current_limit_all()) {
+            if (limit != PROS_ERR && limit > 0) return limit;
+        }
+    }
+    return DEFAULT_CURRENT_LIMIT;
+}
+} // namespace
+
+ThermalGuard::ThermalGuard(Chassis* chassis, pros::MotorGroup* left, pros::MotorGroup* right, ThermalSettings settings,
+                           float minSlew)
+    : chassis(chassis),
+      settings(settings),
+      minSlew(minSlew) {
+    // nothing else can see the guard yet, and the mutex is not taken before the scheduler runs
+    Guarded drive;
+    drive.name = "drive";
+    drive.groups = {left, right};
+    guarded.push_back(drive);
+}
+
+void ThermalGuard::add(const std::string& name, pros::MotorGroup* motors) { add(name, std::vector {motors}); }
+
+void ThermalGuard::add(const std::string& name, const std::vector<pros::MotorGroup*>& groups) {
+    std::lock_guard lock(mutex);
+    Guarded group;
+    group.name = name;
+    group.groups = groups;
+    // already running, so it won't be set up with the rest
+    if (task != nullptr) setUp(group);
+    guarded.push_back(group);
+}
+
+void ThermalGuard::setUp(Guarded& group) {
+    size_t count = 0;
+    for (pros::MotorGroup* motors : group.groups) count += motors->size();
+    group.models.assign(count, ThermalModel(settings));
+    group.fullLimit = currentLimit(group.groups);
+    group.limit = group.fullLimit;
+}
+
+void ThermalGuard::start() {
+    std::lock_guard lock(mutex);
+    if (task != nullptr) return;
+    for (Guarded& group : guarded) setUp(group);
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, 20);
+            update(0.02);
+        }
+    });
+}
+
+ThermalHeadroom ThermalGuard::getHeadroom(const std::string& name) const {
+    std::lock_guard lock(mutex);
+    for (const Guarded& group : guarded) {
+        if (group.name == name) return group.headroom;
+    }
+    return {};
+}
+
+void ThermalGuard::logReport() const {
+    std::lock_guard lock(mutex);
+    for (const Guarded& group : guarded) {
+        if (!std::isfinite(group.hottest)) continue;
+        lemlib::infoSink()->info("{} reached {:.0f}C, now {:.0f}C with {:.0f}C of headroom", group.name, group.hottest,
+                                 group.headroom.temperature, group.headroom.headroom);
+    }
+}
+
+void ThermalGuard::update(float dt) {
+    // add() can grow the list from another task, so it is held for the whole pass
+    std::lock_guard lock(mutex);
+    for (Guarded& group : guarded) {
+        ThermalHeadroom headroom {-INFINITY, INFINITY, INFINITY, 1};
+        size_t model = 0;
+        for (pros::MotorGroup* motors : group.groups) {
+            const std::vector<std::int32_t> currents = motors->get_current_draw_all();
+            const std::vector<double> temperatures = motors->get_temperature_all();
+            const std::vector<std::int32_t> voltages = motors->get_voltage_all();
+            for (size_t i = 0; i < size_t(motors->size()) && model < group.models.size(); i++, model++) {
+                // unplugged motors read PROS_ERR and PROS_ERR_F, and are left out until they are back
+                if (i >= currents.size() || i >= voltages.size() || currents[i] == PROS_ERR ||
+                    voltages[i] == PROS_ERR) {
+                    continue;
+                }
+                ThermalModel& thermal = group.models[model];
+                thermal.update(currents[i] / 1000.0f, std::min(std::abs(voltages[i]) / 12000.0f, 1.0f),
+                               i < temperatures.size() ? temperatures[i] : NAN, dt);
+                headroom.temperature = std::max(headroom.temperature, thermal.getTemperature());
+                headroom.headroom = std::min(headroom.headroom, thermal.getHeadroom());
+                headroom.timeToLimit = std::min(headroom.timeToLimit, thermal.getTimeToLimit());
+                headroom.derate = std::min(headroom.derate, thermal.getDerate());
+            }
+        }
+        // nothing answered
+        if (!std::isfinite(headroom.temperature)) continue;
+
+        if (headroom.derate < 1 && group.headroom.derate >= 1) {
+            lemlib::infoSink()->warn("{} running hot at {:.0f}C, limit in {:.0f}s, easing off", group.name,
+                                     headroom.temperature, headroom.timeToLimit);
+        } else if (headroom.derate >= 1 && group.headroom.derate < 1) {
+            lemlib::infoSink()->info("{} cooled to {:.0f}C, back to full current", group.name, headroom.temperature);
+        }
+        group.headroom = headroom;
+        group.hottest =
+            std::isfinite(group.hottest) ? std::max(group.hottest, headroom.temperature) : headroom.temperature;
+        limitCurrent(group);
+    }
+
+    // the drive's acceleration eases off with its current, from no cap at all down to minSlew
+    const float derate = guarded.front().headroom.derate;
+    float cap = 0;
+    if (derate < 1) {
+        cap = minSlew + (127 - minSlew) * std::max(derate - settings.minDerate, 0.0f) / (1 - settings.minDerate);
+    }
+    if (std::fabs(cap - thermalCap) >= 0.5 || (cap == 0) != (thermalCap == 0)) {
+        thermalCap = cap;
+        chassis->setThermalCap(cap);
+    }
+
+    if (pros::millis() - lastTelemetry >= 5000) {
+        lastTelemetry = pros::millis();
+        for (const Guarded& group : guarded) {
+            if (std::isfinite(group.headroom.timeToLimit)) {
+                lemlib::telemetrySink()->info("{} thermal headroom: {:.1f}C, limit in {:.0f}s, current limit {}mA",
+                                              group.name, group.headroom.headroom, group.headroom.timeToLimit,
+                                              group.limit);
+            } else {
+                lemlib::telemetrySink()->info("{} thermal headroom: {:.1f}C, current limit {}mA", group.name,
+                                              group.headroom.headroom, group.limit);
+            }
+        }
+    }
+}
+
+void ThermalGuard::limitCurrent(Guarded& group) {
+    const std::int32_t limit = std::lround(group.fullLimit * group.headroom.derate);
+    // small steps aren't worth a write to every motor, but getting back to full is
+    if (std::abs(limit - group.limit) < 50 && (limit != group.fullLimit || group.limit == group.fullLimit)) return;
+    group.limit = limit;
+    for (pros::MotorGroup* motors : group.groups) motors->set_current_limit_all(limit);
+}
+} // namespace kachow
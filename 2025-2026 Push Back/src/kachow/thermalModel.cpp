@@ -0,0 +1,42 @@
+#include "kachow/thermalModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+ThermalModel::ThermalModel(ThermalSettings settings)
+    : settings(settings),
+      temperature(settings.ambient) {}
+
+void ThermalModel::update(float current, float duty, float measured, float dt) {
+    if (dt <= 0) return;
+    // start from the motor's own reading, since it may already be warm from the last match
+    if (!started && std::isfinite(measured)) temperature = std::max(measured, settings.ambient);
+    started = started || std::isfinite(measured);
+
+    const float heating = settings.currentHeating * current * current + settings.dutyHeating * std::fabs(duty);
+    load += (heating - load) * std::min(dt / settings.loadTime, 1.0f);
+    temperature += (heating - settings.cooling * (temperature - settings.ambient)) * dt;
+    if (!std::isfinite(measured)) return;
+    const float target = std::clamp(temperature, measured, measured + settings.resolution);
+    temperature += (target - temperature) * std::min(settings.correction * dt, 1.0f);
+}
+
+float ThermalModel::getTemperature() const { return temperature; }
+
+float ThermalModel::getHeadroom() const { return settings.limit - temperature; }
+
+float ThermalModel::getTimeToLimit() const {
+    if (temperature >= settings.limit) return 0;
+    // where the temperature settles at this load, approached exponentially
+    const float settled = settings.ambient + load / settings.cooling;
+    if (settled <= settings.limit) return INFINITY;
+    return std::log((settled - temperature) / (settled - settings.limit)) / settings.cooling;
+}
+
+float ThermalModel::getDerate() const {
+    const float time = getTimeToLimit();
+    if (time >= settings.warnTime) return 1;
+    return settings.minDerate + (1 - settings.minDerate) * time / settings.warnTime;
+}
+} // namespace kachow
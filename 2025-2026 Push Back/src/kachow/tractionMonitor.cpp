@@ -0,0 +1,150 @@
+#include "kachow/tractionMonitor.hpp"
+#include <cmath>
+#include "lemlib/logger/logger.hpp"
+
+namespace kachow {
+
+namespace {
+// in/s², the drive wheels have to speed up or slow down at least this hard for a step to count towards the axis check
+constexpr float AXIS_CHECK_ACCEL = 40;
+// steps one way the axis check needs, and how many times the other way's count, before it decides
+constexpr uint32_t AXIS_CHECK_STEPS = 50;
+constexpr uint32_t AXIS_CHECK_RATIO = 4;
+
+// average of the motors that answered, in motor rpm. Unplugged motors read PROS_ERR_F
+float averageVelocity(pros::MotorGroup* motors) {
+    float total = 0;
+    int count = 0;
+    for (const double velocity : motors->get_actual_velocity_all()) {
+        if (!std::isfinite(velocity)) continue;
+        total += velocity;
+        count++;
+    }
+    return count > 0 ? total / count : NAN;
+}
+
+// from the first motor that answers. Green if none do
+float cartridgeRpm(pros::MotorGroup* motors) {
+    for (const pros::MotorGears gears : motors->get_gearing_all()) {
+        switch (gears) {
+            case pros::MotorGears::red: return 100;
+            case pros::MotorGears::green: return 200;
+            case pros::MotorGears::blue: return 600;
+            default: break;
+        }
+    }
+    return 200;
+}
+} // namespace
+
+TractionMonitor::TractionMonitor(Chassis* chassis, lemlib::TrackingWheel* horizontal, pros::Imu* imu, ImuAxis forward,
+                                 SlipSettings settings)
+    : chassis(chassis),
+      horizontal(horizontal),
+      imu(imu),
+      forward(forward),
+      settings(settings),
+      detector(0, 0, settings) {}
+
+void TractionMonitor::start() {
+    if (task != nullptr) return;
+    // the geometry is read now rather than when constructed, so calibrated values loaded in initialize() are used
+    const lemlib::Drivetrain& drivetrain = chassis->getDrivetrain();
+    leftMotors = drivetrain.leftMotors;
+    rightMotors = drivetrain.rightMotors;
+    detector = SlipDetector(drivetrain.trackWidth, horizontal != nullptr ? horizontal->getOffset() : 0, settings);
+    // the motors report velocity at the cartridge output, the wheels may be geared from there
+    velocityScale = drivetrain.rpm / cartridgeRpm(leftMotors) * M_PI * drivetrain.wheelDiameter / 60;
+    task = new pros::Task([this] {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&now, 10);
+            update(0.01);
+        }
+    });
+}
+
+void TractionMonitor::setAccelerationCap(float slew) { accelerationCap = slew; }
+
+void TractionMonitor::setCorrectOdometry(bool correct) { correctOdometry = correct; }
+
+AxisCheck TractionMonitor::getAxisCheck() const { return axisCheck; }
+
+SlipState TractionMonitor::getState() const { return detector.getState(); }
+
+TractionStats TractionMonitor::getStats() const { return stats; }
+
+void TractionMonitor::update(float dt) {
+    const float left = averageVelocity(leftMotors) * velocityScale;
+    const float right = averageVelocity(rightMotors) * velocityScale;
+    const float lateral = horizontal != nullptr ? horizontal->getDistanceTraveled() : 0;
+    const float rotation = imu->get_rotation();
+    const pros::imu_accel_s_t accel = imu->get_accel();
+    if (!std::isfinite(left) || !std::isfinite(right) || !std::isfinite(lateral) || !std::isfinite(rotation) ||
+        !std::isfinite(accel.x) || imu->is_calibrating()) {
+        // a sensor is missing, nothing to compare against. Let go of the cap rather than leave it stuck on
+        if (capped) chassis->setAccelerationCap(0);
+        capped = false;
+        synced = false;
+        return;
+    }
+    // pick up from wherever the sensors are once they are back
+    if (!synced) {
+        prevLateral = lateral;
+        prevRotation = rotation;
+        prevSpeed = (left + right) / 2;
+        synced = true;
+        return;
+    }
+    float forwardAccel = 0;
+    switch (forward) {
+        case ImuAxis::X: forwardAccel = accel.x; break;
+        case ImuAxis::Y: forwardAccel = accel.y; break;
+        case ImuAxis::NEGATIVE_X: forwardAccel = -accel.x; break;
+        case ImuAxis::NEGATIVE_Y: forwardAccel = -accel.y; break;
+    }
+
+    const bool wasSlipping = detector.getState().slipping;
+    // the accelerometer reads in g
+    const SlipState& state = detector.update({left, right, forwardAccel * 386.09f,
+                                              float((rotation - prevRotation) * M_PI / 180) / dt,
+                                              (lateral - prevLateral) / dt, dt});
+    prevLateral = lateral;
+    prevRotation = rotation;
+
+    // while the wheels grip, the forward axis has to speed up and slow down with them
+    const float speed = (left + right) / 2;
+    const float wheelAccel = (speed - prevSpeed) / dt;
+    prevSpeed = speed;
+    if (axisCheck == AxisCheck::UNCHECKED && !state.slipping && std::fabs(wheelAccel) > AXIS_CHECK_ACCEL) {
+        if ((wheelAccel > 0) == (forwardAccel > 0)) axisAgrees++;
+        else axisDisagrees++;
+        if (axisAgrees >= AXIS_CHECK_STEPS && axisAgrees > AXIS_CHECK_RATIO * axisDisagrees) {
+            axisCheck = AxisCheck::CONFIRMED;
+            lemlib::infoSink()->info("traction: forward axis confirmed over {} steps", axisAgrees + axisDisagrees);
+        } else if (axisDisagrees >= AXIS_CHECK_STEPS && axisDisagrees > AXIS_CHECK_RATIO * axisAgrees) {
+            axisCheck = AxisCheck::WRONG;
+            lemlib::infoSink()->warn("traction: the IMU's forward axis reads backwards, odometry is left alone");
+        }
+    }
+
+    if (state.slipping) {
+        if (!wasSlipping) stats.slipEvents++;
+        stats.slipTime += 10;
+    }
+    if (state.sliding) stats.slideTime += 10;
+
+    if (state.slipping && correctOdometry && axisCheck == AxisCheck::CONFIRMED) {
+        // odometry already counted the wheels, take back the part the ground did not move
+        const float slipped = state.forwardError * dt;
+        const float theta = chassis->getPose(true).theta;
+        chassis->correctPose(-slipped * std::sin(theta), -slipped * std::cos(theta));
+        stats.removedDistance += std::fabs(slipped);
+    }
+
+    // only touch the cap when slipping starts or stops, so it does not fight anyone else using it
+    const bool cap = state.slipping && accelerationCap > 0;
+    if (cap != capped) chassis->setAccelerationCap(cap ? accelerationCap : 0);
+    capped = cap;
+}
+} // namespace kachow
@@ -0,0 +1,147 @@
+#include "kachow/trajectory.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+// wrap an angle to [-pi, pi]
+float wrap(float angle) { return std::remainder(angle, 2 * float(M_PI)); }
+
+// give each point a time from the distance and speed to the last one. The first point is at time 0
+void timeStates(std::vector<TrajectoryState>& states, const std::vector<float>& distance) {
+    for (size_t i = 1; i < states.size(); i++) {
+        const float average = (states[i].velocity + states[i - 1].velocity) / 2;
+        const float ds = distance[i] - distance[i - 1];
+        states[i].time = states[i - 1].time + (average > 0 ? ds / average : 0);
+    }
+}
+} // namespace
+
+Trajectory::Trajectory(std::vector<TrajectoryState> states)
+    : states(std::move(states)) {}
+
+Trajectory Trajectory::fromPath(const SplinePath& path, float maxSpeed, float spacing) {
+    std::vector<TrajectoryState> states;
+    std::vector<float> distance;
+    if (!path.isValid()) return Trajectory();
+    const int steps = std::max(1, int(std::ceil(path.length() / spacing)));
+    for (int i = 0; i <= steps; i++) {
+        const PathPoint point = path.at(path.length() * i / steps);
+        // the path's speeds never reach 0, the robot is meant to come to rest at the end
+        const float velocity = i == steps ? 0 : point.velocity / 127 * maxSpeed;
+        states.push_back({0, point.x, point.y, point.heading, velocity, velocity * point.curvature});
+        distance.push_back(point.distance);
+    }
+    timeStates(states, distance);
+    return Trajectory(std::move(states));
+}
+
+Trajectory Trajectory::generate(const std::vector<SplineSegment>& segments, const TrajectoryConstraints& constraints,
+                                float spacing) {
+    constexpr int steps = 200;
+    std::vector<TrajectoryState> states;
+    std::vector<float> distance;
+    std::vector<float> curvature;
+    if (segments.empty()) return Trajectory();
+
+    // sample every `spacing` inches, found by stepping each segment finely
+    float travelled = 0;
+    float nextSample = 0;
+    float lastX, lastY;
+    segments.front().position(0, lastX, lastY);
+    for (const SplineSegment& segment : segments) {
+        for (int i = 0; i <= steps; i++) {
+            const float t = float(i) / steps;
+            float x, y;
+            segment.position(t, x, y);
+            travelled += std::hypot(x - lastX, y - lastY);
+            lastX = x;
+            lastY = y;
+            const bool end = &segment == &segments.back() && i == steps;
+            if (travelled >= nextSample || end) {
+                states.push_back({0, x, y, segment.heading(t), 0, 0});
+                distance.push_back(travelled);
+                curvature.push_back(segment.curvature(t));
+                nextSample = travelled + spacing;
+            }
+        }
+    }
+
+    // fastest speed at each point, then v² = u² + 2as forwards from rest and backwards to rest
+    for (size_t i = 0; i < states.size(); i++) {
+        const float k = std::fabs(curvature[i]);
+        float velocity = constraints.maxSpeed / (1 + k * constraints.trackWidth / 2);
+        if (constraints.maxLateral > 0 && k > 0) velocity = std::min(velocity, std::sqrt(constraints.maxLateral / k));
+        states[i].velocity = velocity;
+    }
+    states.front().velocity = 0;
+    states.back().velocity = 0;
+    for (size_t i = 1; i < states.size(); i++) {
+        const float reachable = std::sqrt(states[i - 1].velocity * states[i - 1].velocity +
+                                          2 * constraints.maxAccel * (distance[i] - distance[i - 1]));
+        states[i].velocity = std::min(states[i].velocity, reachable);
+    }
+    for (size_t i = states.size() - 1; i-- > 0;) {
+        const float reachable = std::sqrt(states[i + 1].velocity * states[i + 1].velocity +
+                                          2 * constraints.maxAccel * (distance[i + 1] - distance[i]));
+        states[i].velocity = std::min(states[i].velocity, reachable);
+    }
+    for (size_t i = 0; i < states.size(); i++) states[i].angularVelocity = states[i].velocity * curvature[i];
+
+    timeStates(states, distance);
+    return Trajectory(std::move(states));
+}
+
+TrajectoryState Trajectory::sample(float time, float lead) const {
+    if (states.empty()) return {};
+    if (lead != 0) {
+        TrajectoryState state = sample(time);
+        const TrajectoryState ahead = sample(time + lead);
+        state.velocity = ahead.velocity;
+        state.angularVelocity = ahead.angularVelocity;
+        return state;
+    }
+    if (time <= states.front().time) return states.front();
+    if (time >= states.back().time) return states.back();
+    const auto after = std::upper_bound(states.begin(), states.end(), time,
+                                        [](float t, const TrajectoryState& state) { return t < state.time; });
+    const TrajectoryState& a = *(after - 1);
+    const TrajectoryState& b = *after;
+    const float span = b.time - a.time;
+    const float f = span > 0 ? (time - a.time) / span : 0;
+    return {time,
+            a.x + (b.x - a.x) * f,
+            a.y + (b.y - a.y) * f,
+            a.theta + wrap(b.theta - a.theta) * f,
+            a.velocity + (b.velocity - a.velocity) * f,
+            a.angularVelocity + (b.angularVelocity - a.angularVelocity) * f};
+}
+
+float Trajectory::duration() const { return states.empty() ? 0 : states.back().time; }
+
+bool Trajectory::empty() const { return states.empty(); }
+
+const std::vector<TrajectoryState>& Trajectory::getStates() const { return states; }
+
+Ramsete::Ramsete(float b, float zeta, float minGain)
+    : b(b),
+      zeta(zeta),
+      minGain(minGain) {}
+
+TrackerOutput Ramsete::calculate(float x, float y, float theta, const TrajectoryState& goal) const {
+    // error in the robot's frame
+    const float dx = goal.x - x;
+    const float dy = goal.y - y;
+    const float ex = std::cos(theta) * dx + std::sin(theta) * dy;
+    const float ey = -std::sin(theta) * dx + std::cos(theta) * dy;
+    const float eTheta = wrap(goal.theta - theta);
+
+    const float vd = goal.velocity;
+    const float wd = goal.angularVelocity;
+    const float k = std::fmax(2 * zeta * std::sqrt(wd * wd + b * vd * vd), minGain);
+    // sin(x)/x, which is 1 at 0
+    const float sinc = std::fabs(eTheta) < 1e-6f ? 1 : std::sin(eTheta) / eTheta;
+    return {vd * std::cos(eTheta) + k * ex, wd + k * eTheta + b * vd * sinc * ey};
+}
+} // namespace kachow
@@ -0,0 +1,101 @@
+#include "kachow/wallLocalizer.hpp"
+#include <cmath>
+
+namespace kachow {
+
+namespace {
+float toRadians(float degrees) { return degrees * M_PI / 180; }
+} // namespace
+
+FieldMap::FieldMap(float size)
+    : segments({{0, 0, size, 0}, {size, 0, size, size}, {size, size, 0, size}, {0, size, 0, 0}}) {}
+
+void FieldMap::addSegment(FieldSegment segment) { segments.push_back(segment); }
+
+void FieldMap::addBox(float x1, float y1, float x2, float y2) {
+    segments.push_back({x1, y1, x2, y1});
+    segments.push_back({x2, y1, x2, y2});
+    segments.push_back({x2, y2, x1, y2});
+    segments.push_back({x1, y2, x1, y1});
+}
+
+RayHit FieldMap::raycast(float x, float y, float heading) const {
+    // compass heading, so x uses sin and y uses cos
+    const float dx = std::sin(toRadians(heading));
+    const float dy = std::cos(toRadians(heading));
+    RayHit hit {INFINITY, 0, 0};
+    for (const FieldSegment& segment : segments) {
+        const float sx = segment.x2 - segment.x1;
+        const float sy = segment.y2 - segment.y1;
+        const float denominator = dx * sy - dy * sx;
+        // parallel to the wall
+        if (std::fabs(denominator) < 1e-6f) continue;
+        const float ox = segment.x1 - x;
+        const float oy = segment.y1 - y;
+        const float distance = (ox * sy - oy * sx) / denominator;
+        const float along = (ox * dy - oy * dx) / denominator;
+        if (distance < 0 || along < 0 || along > 1 || distance >= hit.distance) continue;
+        const float length = std::hypot(sx, sy);
+        float normalX = -sy / length;
+        float normalY = sx / length;
+        if (normalX * dx + normalY * dy > 0) {
+            normalX = -normalX;
+            normalY = -normalY;
+        }
+        hit = {distance, normalX, normalY};
+    }
+    return hit;
+}
+
+const std::vector<FieldSegment>& FieldMap::getSegments() const { return segments; }
+
+WallLocalizer::WallLocalizer(FieldMap map, std::vector<SensorMount> mounts, LocalizerSettings settings)
+    : map(std::move(map)),
+      mounts(std::move(mounts)),
+      settings(settings) {}
+
+RayHit WallLocalizer::expected(size_t sensor, float x, float y, float theta) const {
+    const SensorMount& mount = mounts[sensor];
+    const float sin = std::sin(toRadians(theta));
+    const float cos = std::cos(toRadians(theta));
+    // robot frame to field frame, x right and y forwards
+    const float sensorX = x + mount.x * cos + mount.y * sin;
+    const float sensorY = y - mount.x * sin + mount.y * cos;
+    return map.raycast(sensorX, sensorY, theta + mount.heading);
+}
+
+Correction WallLocalizer::correct(float x, float y, float theta, float xVelocity, float yVelocity,
+                                  const std::vector<DistanceReading>& readings) const {
+    const float minIncidence = std::cos(toRadians(settings.maxIncidence));
+    // corrections are averaged per axis, weighted by how much each wall faces that axis
+    float sumX = 0, sumY = 0, weightX = 0, weightY = 0;
+    int used = 0;
+    for (size_t i = 0; i < mounts.size() && i < readings.size(); i++) {
+        const DistanceReading& reading = readings[i];
+        // the sensor only reports a confidence past 200mm
+        if (reading.distance > 7.87f && reading.confidence < settings.minConfidence) continue;
+        if (reading.objectSize < settings.minObjectSize || reading.distance > settings.maxDistance) continue;
+
+        const RayHit hit = expected(i, x, y, theta);
+        if (!std::isfinite(hit.distance)) continue;
+        const float heading = toRadians(theta + mounts[i].heading);
+        // cosine of the angle between the ray and the wall normal
+        const float incidence = -(std::sin(heading) * hit.normalX + std::cos(heading) * hit.normalY);
+        if (incidence < minIncidence) continue;
+        if (std::fabs(xVelocity * hit.normalX + yVelocity * hit.normalY) > settings.maxSpeed) continue;
+        const float residual = reading.distance - hit.distance;
+        if (std::fabs(residual) > settings.maxResidual) continue;
+
+        // reading further than expected means the robot is further from the wall than odometry thinks
+        const float shift = residual * incidence;
+        sumX += hit.normalX * shift;
+        sumY += hit.normalY * shift;
+        weightX += std::fabs(hit.normalX);
+        weightY += std::fabs(hit.normalY);
+        used++;
+    }
+    return {weightX > 0 ? sumX / weightX * settings.gain : 0, weightY > 0 ? sumY / weightY * settings.gain : 0, used};
+}
+
+size_t WallLocalizer::size() const { return mounts.size(); }
+} // namespace kachow
@@ -8,29 +8,70 @@
 #include "pros/rtos.hpp"
 #include "pros/screen.h"
 #include "pros/screen.hpp"
+#include "kachow/autotune.hpp"
+#include "kachow/chassis.hpp"
+#include "kachow/config.hpp"
+#include "kachow/controllerInput.hpp"
+#include "kachow/deviceCache.hpp"
+#include "kachow/deviceMonitor.hpp"
+#include "kachow/distanceLocalization.hpp"
+#include "kachow/driverLoop.hpp"
+#include "kachow/driveFailover.hpp"
+#include "kachow/driverProfile.hpp"
+#include "kachow/dualImu.hpp"
+#include "kachow/fusedOdometry.hpp"
+#include "kachow/geometryCalibration.hpp"
+#include "kachow/lutDriveCurve.hpp"
+#include "kachow/startupSequencer.hpp"
+#include "kachow/thermalGuard.hpp"
+#include "kachow/tractionMonitor.hpp"
+#include <atomic>
 #include <cmath>
+#include <string>
+#include <vector>
 
 pros::Controller master(pros::E_CONTROLLER_MASTER);
-
-// motor groups
-pros::MotorGroup leftMotors({-13, 15, -16}, pros::MotorGearset::blue);
-pros::MotorGroup rightMotors({17, -18, 19}, pros::MotorGearset::blue);
+// samples master once per driver control loop
+kachow::ControllerInput driver(&master);
+// runs opcontrol as soon as the throttle moves, everything else is read every
+// 10ms. Latency is logged every 5s. Switch to FREE_RUNNING for the old fixed
+// 10ms loop
+kachow::DriverLoop driverLoop(&driver, kachow::LoopMode::LOW_LATENCY, 10, 2,
+                              5000);
+
+// motor groups. Either side is scaled down to match the other if it loses a
+// motor, see failover
+kachow::BalancedMotorGroup leftMotors({-13, 15, -16}, pros::MotorGearset::blue);
+kachow::BalancedMotorGroup rightMotors({17, -18, 19}, pros::MotorGearset::blue);
 
 // Intake Motors
-pros::MotorGroup Intake({11,-20}, pros::MotorGearset::blue);
+pros::MotorGroup IntakeMotors({11,-20}, pros::MotorGearset::blue);
 
 // Pneumatics
-pros::adi::DigitalOut MatchLoader('D');
-pros::adi::DigitalOut Holder('A');
-pros::adi::DigitalOut MiddleGoal('E');
-pros::adi::DigitalOut LeftWing('B');
-pros::adi::DigitalOut RightWing('C');
-
-// Inertial Sensor
-pros::Imu imu(10); //change
+pros::adi::DigitalOut MatchLoaderPiston('D');
+pros::adi::DigitalOut HolderPiston('A');
+pros::adi::DigitalOut MiddleGoalPiston('E');
+pros::adi::DigitalOut LeftWingPiston('B');
+pros::adi::DigitalOut RightWingPiston('C');
+
+// cached wrappers, only send a command when it changes what the device is doing
+kachow::CachedMotorGroup Intake(&IntakeMotors);
+kachow::CachedMotorGroup leftDrive(&leftMotors);
+kachow::CachedMotorGroup rightDrive(&rightMotors);
+kachow::CachedDigitalOut MatchLoader(&MatchLoaderPiston);
+kachow::CachedDigitalOut Holder(&HolderPiston);
+kachow::CachedDigitalOut MiddleGoal(&MiddleGoalPiston);
+kachow::CachedDigitalOut LeftWing(&LeftWingPiston);
+kachow::CachedDigitalOut RightWing(&RightWingPiston);
+
+// Inertial Sensors, fused into one heading. Bias is learned whenever the robot
+// sits still, so the heading holds through a whole skills run
+kachow::DualImu imu(10, 9, &leftMotors, &rightMotors); //change
 
 // tracking wheels
-pros::Rotation horizontalEnc(21); //change
+// reads as if the robot never slid sideways while unplugged, so odometry falls
+// back to the drive encoders and IMU instead of jumping
+kachow::GuardedRotation horizontalEnc(21); //change
 // pros::Rotation verticalEnc(-11);
 
 lemlib::TrackingWheel horizontal(&horizontalEnc, lemlib::Omniwheel::NEW_2, -1.5); // up is positive, back is negative
@@ -83,8 +124,10 @@ lemlib::OdomSensors sensors(nullptr, // vertical tracking wheel
 
 // Test out increasing Curve, decreasing min output, and decreasing deadband
 // input curve for throttle input during driver control. Decrease minoutput
-// first
-lemlib::ExpoDriveCurve
+// first. Same mapping as lemlib::ExpoDriveCurve, precomputed into a table at
+// compile time. These are the boot values, the selected driver profile
+// replaces them
+constinit kachow::LutDriveCurve
     throttleCurve(3,    // joystick deadband out of 127
                   5,   // minimum output where drivetrain will move out of 127
                   1.02 // expo curve gain
@@ -92,38 +135,344 @@ lemlib::ExpoDriveCurve
 
 // try decreasing curve, decreasing deadband, and decreasing min output -->
 // should help dhruva turn more accurately at low speeds. Decrease curve first
-lemlib::ExpoDriveCurve
+constinit kachow::LutDriveCurve
     steerCurve(3,    // joystick deadband out of 127
                5,   // minimum output where drivetrain will move out of 127
                1.02 // expo curve gain
     );
 
 // create the chassis
-lemlib::Chassis chassis(drivetrain, linearController, angularController,
+kachow::Chassis chassis(drivetrain, linearController, angularController,
                         sensors, &throttleCurve, &steerCurve);
 
+// angular gains for turnToHeading by turn size (10, 45 and 180 degrees) and
+// turning speed (still and 300 deg/s). Starts out as the angularController
+// gains everywhere, or the autotuned angular gains once there are some; set
+// tuneTurns and tune one band at a time from the log. PLACEHOLDER: no band has
+// been tuned yet, so until then every band turns exactly like the plain
+// controller and the schedule changes nothing
+kachow::GainSchedule angularSchedule({10, 45, 180}, {0, 300},
+                                     {{1.8, 0, 10}, {1.8, 0, 10},
+                                      {1.8, 0, 10}, {1.8, 0, 10},
+                                      {1.8, 0, 10}, {1.8, 0, 10}});
+const bool tuneTurns = false;
+
+// distance sensors that keep x and y honest against the field walls between
+// the setPose resets. Offsets are from the tracking center, right and forwards
+pros::Distance leftDistanceSensor(1); //change
+pros::Distance backDistanceSensor(2); //change
+kachow::DistanceLocalization localization(
+    &chassis, {&leftDistanceSensor, &backDistanceSensor},
+    kachow::WallLocalizer(kachow::FieldMap(), {{-6, 0, -90},  // left side
+                                               {0, -7, 180}})); // back
+
+// pose estimate with a covariance, so autons can tell how far to trust the
+// pose before scoring. Follows every chassis.setPose
+kachow::FusedOdometry fusedOdometry(&chassis, &horizontal, &imu);
+
+// drive wheel slip: caps acceleration until the wheels grip again, and takes
+// slipped distance back out of odometry once the first drives have confirmed
+// which IMU axis faces forwards. The brain logs whether it was right
+kachow::TractionMonitor traction(&chassis, &horizontal, &imu,
+                                 kachow::ImuAxis::Y); //change
+
+// drive motor failover: when a drive motor drops out, overheats or strips, the
+// other side is scaled to match and motions get longer to finish
+kachow::DriveFailover failover(&chassis, &leftMotors, &rightMotors);
+
+// motor heat: eases the drive and intake current, and the drive's
+// acceleration, off before the motors throttle themselves
+kachow::ThermalGuard thermals(&chassis, &leftMotors, &rightMotors);
+
+// start up steps, run in parallel by initialize()
+kachow::StartupSequencer startup;
+
+// checks every port for loose cables and motor faults
+kachow::DeviceMonitor devices;
+
+// odometry geometry. Starts as the hand measured values above, replaced by
+// the calibrated ones from the SD card in initialize()
+kachow::OdometryGeometry geometry{11.375, lemlib::Omniwheel::NEW_325,
+                                  lemlib::Omniwheel::NEW_2, -1.5};
+// geometry calibration: the gap between the front of the robot and the wall
+// ahead, and how far to slide the robot sideways by hand (0 to skip), both
+// measured with a tape
+const float calibrationGap = 48;   //change
+const float calibrationSlide = 12; //change
+
 // Auton Selector
 int autonomousMode = 0;
-int matchLoaderState = 0; // 0 is retracted, 1 is extended
-int leftWingState = 0; // 0 is retracted, 1 is extended
-int rightWingState = 0; // 0 is retracted, 1 is extended
+
+// Driver profiles, loaded from /usd/driver0.cfg to /usd/driver2.cfg
+const int maxDriverProfiles = 3;
+const char *robotConfigPath = "/usd/kachow.cfg";
+std::vector<kachow::DriverProfile> driverProfiles;
+int selectedProfile = 0;
+// compiled by the touch task, picked up by the driver loop
+std::atomic<kachow::CompiledProfile *> pendingProfile = nullptr;
+kachow::DriveMode driveMode = kachow::DriveMode::TANK;
+kachow::ControllerInput::Buttons intakeHoldButtons;
+kachow::ControllerInput::Buttons scoreHighButtons;
+kachow::ControllerInput::Buttons scoreMiddleButtons;
+kachow::ControllerInput::Buttons outakeButtons;
 
 const int buttonWidth = 100;
 const int buttonHeight = 30;
-const int cols = 3;
+const int cols = 4;
 const int rows = 2;
-const int xSpacing = 50;
+const int xSpacing = 16;
 const int ySpacing = 20;
 const int startX = 10;
 const int startY = 100;
 
-const char *buttonLabels[6] = {
-    "AWP", "Right Side", "Left Side", "Right 9+0", "Left 4+3 Wing", "Skills"};
+const int autonCount = 8;
+const char *buttonLabels[autonCount] = {
+    "AWP",           "Right Side", "Left Side", "Right 9+0",
+    "Left 4+3 Wing", "Skills",     "Tune",      "Geometry"};
+
+// driver profile buttons sit in a row above the auton buttons
+const int profileY = 40;
+
+// the current driver setup, used when the SD card has no profiles
+kachow::DriverProfile defaultDriverProfile() {
+  kachow::DriverProfile profile;
+  profile.bindings = {{"intakeHold", "R2"},   {"scoreHigh", "R1"},
+                      {"scoreMiddle", "R2+L2"}, {"outake", "L2"},
+                      {"matchLoader", "L1"},  {"leftWing", "DOWN"},
+                      {"leftWingAlt", "B"},   {"skills", "Y"}};
+  return profile;
+}
+
+void loadDriverProfiles() {
+  for (int i = 0; i < maxDriverProfiles; i++) {
+    kachow::DriverProfile profile = defaultDriverProfile();
+    std::string path = "/usd/driver" + std::to_string(i) + ".cfg";
+    if (profile.load(path)) driverProfiles.push_back(profile);
+    // seed the card with the defaults so there is a file to edit
+    else if (i == 0 && pros::usd::is_installed()) profile.save(path);
+  }
+  if (driverProfiles.empty()) driverProfiles.push_back(defaultDriverProfile());
+
+  kachow::Config config;
+  config.load(robotConfigPath);
+  selectedProfile = config.getInt("driver", 0);
+  if (selectedProfile < 0 || selectedProfile >= (int)driverProfiles.size())
+    selectedProfile = 0;
+}
+
+// build the tables for a profile now, so the driver loop only has to swap them
+// in. Remembers the choice on the SD card unless told not to
+void selectDriverProfile(int index, bool remember = true) {
+  selectedProfile = index;
+  delete pendingProfile.exchange(
+      new kachow::CompiledProfile(driverProfiles[index].compile()));
+  if (!remember) return;
+
+  kachow::Config config;
+  config.load(robotConfigPath);
+  config.set("driver", index);
+  config.save(robotConfigPath);
+}
+
+void skills();
+
+// gains from the last tune, saved on the SD card so they survive a restart
+void loadTunedGains() {
+  kachow::Config config;
+  config.load(robotConfigPath);
+  kachow::Gains gains;
+  if (kachow::loadGains(config, "lateral", gains))
+    chassis.setLateralGains(gains);
+  if (kachow::loadGains(config, "angular", gains)) {
+    chassis.setAngularGains(gains);
+    angularSchedule.fill(gains); // turns use the schedule, not the controller
+  }
+  if (config.has("latency")) chassis.setLatency(config.getFloat("latency"));
+  if (config.has("timeConstant"))
+    chassis.setTimeConstant(config.getFloat("timeConstant"));
+}
+
+// measure the drive's latency, then relay tune both drive controllers in place
+// and keep the results. Needs about a tile of clear space. The angular result
+// replaces every band of the turn schedule, so band tuning starts again from it
+void tuneControllers() {
+  kachow::Config config;
+  config.load(robotConfigPath);
+
+  // the relay tests see the real plant, latency and all, so the gains they give
+  // already allow for it
+  kachow::StepResponse response = chassis.measureLatency();
+  if (response.valid) {
+    chassis.setLatency(response.deadTime * 1000);
+    chassis.setTimeConstant(response.timeConstant * 1000);
+    config.set("latency", chassis.getLatency());
+    config.set("timeConstant", chassis.getTimeConstant());
+  }
+  pros::delay(500);
+  kachow::RelayResult lateral = chassis.autotuneLateral();
+  if (lateral.valid) {
+    kachow::Gains gains =
+        kachow::relayGains(lateral, kachow::TuningRule::PD, 0.01);
+    chassis.setLateralGains(gains);
+    kachow::saveGains(config, "lateral", gains);
+  }
+  pros::delay(500);
+  kachow::RelayResult angular = chassis.autotuneAngular();
+  if (angular.valid) {
+    kachow::Gains gains =
+        kachow::relayGains(angular, kachow::TuningRule::PD, 0.01);
+    chassis.setAngularGains(gains);
+    angularSchedule.fill(gains);
+    kachow::saveGains(config, "angular", gains);
+  }
+  config.save(robotConfigPath);
+}
+
+// calibrated odometry geometry from the SD card. Must run before
+// chassis.calibrate(), which builds odometry from it
+void loadOdometryGeometry() {
+  kachow::Config config;
+  config.load(robotConfigPath);
+  kachow::loadGeometry(config, "geometry", geometry);
+  chassis.setDriveGeometry(geometry.trackWidth, geometry.driveDiameter);
+  horizontal = lemlib::TrackingWheel(&horizontalEnc, geometry.trackingDiameter,
+                                     geometry.trackingOffset);
+  horizontalEnc.setFallback(&imu, geometry.trackingDiameter,
+                            geometry.trackingOffset);
+}
+
+// watch every device, so a loose cable gets noticed instead of failing quietly
+void watchDevices() {
+  devices.add("drive left", &leftMotors);
+  devices.add("drive right", &rightMotors);
+  devices.add("intake", &IntakeMotors);
+  devices.add("IMU", imu.get_port(), pros::DeviceType::imu);
+  devices.add("horizontal wheel", horizontalEnc.get_port(),
+              pros::DeviceType::rotation);
+  // not fitted on every robot yet, so only watched once they turn up
+  devices.add("second IMU", imu.getSecondPort(), pros::DeviceType::imu, true);
+  devices.add("left distance", leftDistanceSensor.get_port(),
+              pros::DeviceType::distance, true);
+  devices.add("back distance", backDistanceSensor.get_port(),
+              pros::DeviceType::distance, true);
+  devices.onChange([](const kachow::DeviceHealth &health) {
+    // DualImu and GuardedRotation switch over on their own, this is to tell the
+    // driver and the log
+    if (health.status != kachow::DeviceStatus::OK)
+      master.rumble("-");
+    if (health.port != horizontalEnc.get_port())
+      return;
+    if (health.status == kachow::DeviceStatus::OK)
+      lemlib::infoSink()->info("odometry back on the tracking wheel");
+    else
+      lemlib::infoSink()->warn("odometry on the drive encoders only");
+  });
+  devices.start();
+}
+
+// measure the odometry geometry and keep it for the next restart. Start square
+// to a wall calibrationGap inches ahead, with a tile of clear space around
+void calibrateGeometry() {
+  kachow::GeometrySolver solver(geometry);
+  // the wall run first, while the gap is the one the robot was placed at
+  solver.addStraight(chassis.measureWallRun(), calibrationGap);
+
+  // back off a tile so the robot can spin clear of the wall
+  const lemlib::Pose wall = chassis.getPose(true);
+  chassis.moveToPoint(wall.x - 24 * std::sin(wall.theta),
+                      wall.y - 24 * std::cos(wall.theta), 3000,
+                      {.forwards = false});
+  chassis.waitUntilDone();
+  const float heading = chassis.getPose().theta;
+  // as much each way, so the IMU's drift cancels out
+  for (int i = 0; i < 2; i++) {
+    solver.addSpin(chassis.measureSpin(3));
+    solver.addSpin(chassis.measureSpin(-3));
+  }
+  chassis.turnToHeading(heading, 2000);
+  chassis.waitUntilDone();
+
+  if (calibrationSlide > 0) {
+    // LemLib counts the horizontal wheel left positive
+    pros::lcd::print(4, "Slide the robot %.1fin left,", calibrationSlide);
+    pros::lcd::print(5, "then press A");
+    const float start = horizontal.getDistanceTraveled();
+    while (!master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_A))
+      pros::delay(20);
+    solver.addSlide(horizontal.getDistanceTraveled() - start, calibrationSlide);
+    if (solver.isSlideBackwards()) {
+      lemlib::infoSink()->warn("tracking wheel read the slide backwards, "
+                               "keeping its diameter. Slide left, or reverse "
+                               "the rotation sensor");
+    }
+  }
+
+  geometry = solver.solve();
+  kachow::Config config;
+  config.load(robotConfigPath);
+  kachow::saveGeometry(config, "geometry", geometry);
+  config.save(robotConfigPath);
+  pros::lcd::print(4, "Track %.3f Drive %.3f", geometry.trackWidth,
+                   geometry.driveDiameter);
+  pros::lcd::print(5, "Tracking %.3f at %.2f (spread %.3f)",
+                   geometry.trackingDiameter, geometry.trackingOffset,
+                   solver.spinSpread());
+  lemlib::infoSink()->info(
+      "geometry: track width {}, drive wheel {}, tracking wheel {} at {}, "
+      "spin spread {}. Restart to use it",
+      geometry.trackWidth, geometry.driveDiameter, geometry.trackingDiameter,
+      geometry.trackingOffset, solver.spinSpread());
+}
+
+// swap in a profile compiled by selectDriverProfile. Must not run from inside
+// driver.update(), since it replaces the bindings
+void applyPendingProfile() {
+  kachow::CompiledProfile *profile = pendingProfile.exchange(nullptr);
+  if (profile == nullptr) return;
+
+  driveMode = profile->driveMode;
+  throttleCurve = profile->throttleCurve;
+  steerCurve = profile->steerCurve;
+  intakeHoldButtons = profile->bindings["intakeHold"];
+  scoreHighButtons = profile->bindings["scoreHigh"];
+  scoreMiddleButtons = profile->bindings["scoreMiddle"];
+  outakeButtons = profile->bindings["outake"];
+
+  // toggles and shortcuts, run by driver.update()
+  driver.clearBindings();
+  driver.bind(profile->bindings["matchLoader"], kachow::Trigger::PRESSED,
+              [] { MatchLoader.toggle(); });
+  driver.bind(profile->bindings["leftWing"], kachow::Trigger::PRESSED,
+              [] { LeftWing.toggle(); });
+  driver.bind(profile->bindings["leftWingAlt"], kachow::Trigger::PRESSED,
+              [] { LeftWing.toggle(); });
+  driver.bind(profile->bindings["skills"], kachow::Trigger::PRESSED,
+              [] { skills(); });
+  delete profile;
+}
+
+void draw_profile_selection() {
+  pros::screen::set_pen(pros::c::COLOR_BLACK);
+  pros::screen::fill_rect(0, 0, 480, profileY - 1); // Clear top
+  pros::screen::set_pen(pros::c::COLOR_YELLOW);
+  pros::screen::print(pros::E_TEXT_MEDIUM, 10, 10, "Driver: %s",
+                      driverProfiles[selectedProfile].name.c_str());
+}
 
 void draw_buttons() {
   pros::screen::erase();
 
-  for (int i = 0; i < 6; i++) {
+  for (int i = 0; i < (int)driverProfiles.size(); i++) {
+    pros::screen::set_pen(pros::c::COLOR_BLUE);
+    int x = startX + i * (buttonWidth + xSpacing);
+    pros::screen::fill_rect(x, profileY, x + buttonWidth, profileY + buttonHeight);
+    pros::screen::set_pen(pros::c::COLOR_WHITE);
+    pros::screen::print(pros::E_TEXT_SMALL, x + 5, profileY + 15,
+                        driverProfiles[i].name.c_str());
+  }
+  draw_profile_selection();
+
+  for (int i = 0; i < autonCount; i++) {
     pros::screen::set_pen(pros::c::COLOR_RED);
     int col = i % cols;
     int row = i / cols;
@@ -147,7 +496,16 @@ void check_touch() {
       int tx = touch.x;
       int ty = touch.y;
 
-      for (int i = 0; i < 12; i++) {
+      for (int i = 0; i < (int)driverProfiles.size(); i++) {
+        int x = startX + i * (buttonWidth + xSpacing);
+        if (i != selectedProfile && tx >= x && tx <= x + buttonWidth &&
+            ty >= profileY && ty <= profileY + buttonHeight) {
+          selectDriverProfile(i);
+          draw_profile_selection();
+        }
+      }
+
+      for (int i = 0; i < autonCount; i++) {
         int col = i % cols;
         int row = i / cols;
         int x = startX + col * (buttonWidth + xSpacing);
@@ -168,23 +526,94 @@ void check_touch() {
   }
 }
 
+// total number of device commands the write caches have dropped
+uint32_t writesSuppressed() {
+  uint32_t total = 0;
+  for (const kachow::CachedMotorGroup* group : {&Intake, &leftDrive, &rightDrive})
+    total += group->getStats().suppressed;
+  for (const kachow::CachedDigitalOut* out :
+       {&MatchLoader, &Holder, &MiddleGoal, &LeftWing, &RightWing})
+    total += out->getStats().suppressed;
+  return total;
+}
+
 void initialize() {
   pros::lcd::initialize(); // initialize brain screen
-  chassis.calibrate();     // calibrate sensors
-  imu.reset();
-  MatchLoader.set_value(false); // Initialize piston to retracted state
-  Holder.set_value(false); // Initialize piston to retracted state
-  chassis.setBrakeMode(MOTOR_BRAKE_COAST);
-  Intake.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-  
-  draw_buttons();
-  pros::Task touchTask(check_touch);
+  watchDevices();
+
+  // start up runs in parallel, so the selector is up while the IMUs calibrate.
+  // autonomous and opcontrol wait for it all to finish
+  const int config = startup.add("config", [] {
+    loadOdometryGeometry(); // before chassis.calibrate, which uses it
+    loadTunedGains();
+    loadDriverProfiles();
+    selectDriverProfile(selectedProfile, false);
+    applyPendingProfile();
+  });
+  const int imuCalibration = startup.add("IMU", [] {
+    imu.start(); // before the reset, so the fused heading restarts with it
+    imu.reset(true);
+  });
+  startup.add(
+      "odometry",
+      [] {
+        chassis.calibrate(false); // IMUs are done, this zeroes the encoders
+        chassis.setAngularSchedule(&angularSchedule);
+        chassis.setTuningMode(tuneTurns);
+        localization.start();
+        traction.setCorrectOdometry(true); // waits for the axis check
+        traction.start();
+        fusedOdometry.setTractionMonitor(&traction);
+        fusedOdometry.start();
+        failover.start();
+        thermals.add("intake", &IntakeMotors);
+        thermals.start();
+      },
+      {config, imuCalibration});
+  startup.add("pistons", [] {
+    MatchLoader.set_value(false); // Initialize piston to retracted state
+    Holder.set_value(false); // Initialize piston to retracted state
+    chassis.setBrakeMode(MOTOR_BRAKE_COAST);
+    Intake.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+  });
+  startup.add(
+      "selector",
+      [] {
+        draw_buttons();
+        pros::Task touchTask(check_touch);
+      },
+      {config});
+  startup.start();
+
   pros::Task screenTask([&]() {
+    bool readyShown = false;
     while (true) {
+      // start up progress, the robot must stay still until it is ready. Ready
+      // is only printed once, so calibration prompts can use the line after
+      if (!startup.isReady()) {
+        pros::lcd::print(4, "Starting %d/%d: %s, don't move",
+                         startup.finished(), startup.count(),
+                         startup.running().c_str());
+      } else if (!readyShown) {
+        pros::lcd::print(4, "Ready in %.1fs", startup.getReadyTime() / 1000.0);
+        readyShown = true;
+      }
+      // details of any problem are in the log
+      pros::lcd::print(6, "%s",
+                       devices.allHealthy() ? "Devices OK"
+                                            : "DEVICE PROBLEM, check the log");
+      // how far the hottest drive motor is from throttling
+      const kachow::ThermalHeadroom heat = thermals.getHeadroom("drive");
+      if (std::isfinite(heat.headroom)) {
+        pros::lcd::print(7, "Drive %.0fC, %.0fC headroom, %.0f%% current",
+                         heat.temperature, heat.headroom, heat.derate * 100);
+      }
       // print robot location to the brain screen
       pros::lcd::print(0, "X: %f", chassis.getPose().x);         // x
       pros::lcd::print(1, "Y: %f", chassis.getPose().y);         // y
       pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
+      // commands saved by the write caches
+      pros::lcd::print(3, "Writes saved: %d", (int)writesSuppressed());
 
       // log position telemetry"
       lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
@@ -198,10 +627,14 @@ void initialize() {
 void disabled() {
   MatchLoader.set_value(false);
   LeftWing.set_value(false);
+  imu.logReport(); // how far the heading drifted over the run just finished
+  devices.logReport();
+  thermals.logReport(); // how hot back to back matches are getting
 }
 
 // initalize everything
 void competition_initialize() {
+  startup.waitUntilReady(); // the selector needs the driver profiles
   draw_buttons();
   pros::Task touchTask(check_touch);
 }
@@ -439,6 +872,7 @@ void skills(){
 
 // switch statement for autos
 void autonomous() {
+  startup.waitUntilReady(); // don't move until the sensors are up
   switch (autonomousMode) {
   case 1:
     AWP();
@@ -458,6 +892,12 @@ void autonomous() {
   case 6:
     skills();
     break;
+  case 7:
+    tuneControllers();
+    break;
+  case 8:
+    calibrateGeometry();
+    break;
   default:
     right7ball();
     break;
@@ -465,58 +905,50 @@ void autonomous() {
 }
 
 void opcontrol() {
+  startup.waitUntilReady(); // don't move until the sensors are up
   // if(autonomousMode == 0){
   //   LeftWing.set_value(true);
-  //   leftWingState = 1;
   // }
-  while (true) {
-    chassis.setBrakeMode(MOTOR_BRAKE_COAST);
-    int leftY = master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
-    int rightY = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
-    chassis.tank(leftY, rightY);
-
-    if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R2) && !master.get_digital(pros::E_CONTROLLER_DIGITAL_L2)){
-      Holder.set_value(false);
-      MiddleGoal.set_value(false);
-      Intake.move_velocity(600);
-    }
-    else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R1)){
-      Holder.set_value(true);
-      MiddleGoal.set_value(false);
-      Intake.move_velocity(600);
-    }
-    else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R2) && master.get_digital(pros::E_CONTROLLER_DIGITAL_L2)){
-      Holder.set_value(false);
-      MiddleGoal.set_value(true);
-      Intake.move_velocity(600);
-    }
-    else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_L2) && !master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)){
-      Intake.move_velocity(-600);
-    }
-    else{
-      Intake.move_velocity(0);
+  // auton may have changed the brake mode through lemlib, so resend it
+  leftDrive.invalidate();
+  rightDrive.invalidate();
+  // only the throttle is read every 2ms, so the faster loop costs one extra
+  // controller read per poll rather than a full sample
+  driver.pollFast(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+  driverLoop.run([] {
+    // driver changed on the brain screen, tables are already built
+    applyPendingProfile();
+    leftDrive.set_brake_mode(MOTOR_BRAKE_COAST);
+    rightDrive.set_brake_mode(MOTOR_BRAKE_COAST);
+    int leftY = driver.getAxis(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+    switch (driveMode) {
+    case kachow::DriveMode::TANK:
+      chassis.tank(leftY, driver.getAxis(pros::E_CONTROLLER_ANALOG_RIGHT_Y));
+      break;
+    case kachow::DriveMode::ARCADE:
+      chassis.arcade(leftY, driver.getAxis(pros::E_CONTROLLER_ANALOG_RIGHT_X));
+      break;
+    case kachow::DriveMode::CURVATURE:
+      chassis.curvature(leftY,
+                        driver.getAxis(pros::E_CONTROLLER_ANALOG_RIGHT_X));
+      break;
     }
 
-    if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L1)){
-      MatchLoader.set_value(!matchLoaderState);
-      matchLoaderState = !matchLoaderState;
+    // combinations first, so R2+L2 is not taken as R2 alone
+    if(driver.held(scoreMiddleButtons)){
+      intakeScoreMiddle();
     }
-
-    if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)){
-      LeftWing.set_value(!leftWingState);
-      leftWingState = !leftWingState;
+    else if(driver.held(intakeHoldButtons)){
+      intakeHold();
     }
-
-    if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_B)){
-      LeftWing.set_value(!leftWingState);
-      leftWingState = !leftWingState;
+    else if(driver.held(scoreHighButtons)){
+      intakeScoreHigh();
     }
-
-    if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_Y)){
-      skills();
+    else if(driver.held(outakeButtons)){
+      outake();
     }
-
-    // delay to save resources
-    pros::delay(10);
-  }
-}
\ No newline at end of file
+    else{
+      intakeStop();
+    }
+  });
+}
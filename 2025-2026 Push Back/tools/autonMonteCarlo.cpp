@@ -0,0 +1,556 @@
+/**
+ * @file autonMonteCarlo.cpp
+ * @brief Monte Carlo robustness check of the autonomous routines on the drivetrain simulation
+ *
+ * Runs AWP, right7ball, left4plus3 and skills thousands of times each, on all cores, driving sim::DriveSim with the
+ * motions main.cpp actually runs: turns are kachow::Chassis::turnToHeading with the angular schedule from main.cpp,
+ * using the real kachow::ScheduledPID, and moveToPoint and moveToPose are LemLib's from lemlibSim.hpp. Every run
+ * perturbs the starting pose, the wheel diameter, IMU drift and scale, the battery voltage and the strength of each
+ * side. Odometry works like the robot's: drive encoders that assume the nominal wheel size, and an IMU that drifts.
+ *
+ * For each routine it prints the distribution of completion time, and for each scoring point the distribution of how
+ * far the robot was from where an unperturbed run put it. A routine whose p95 error is large at a scoring point is
+ * fragile there, whatever the average says.
+ *
+ * The routines are transcribed from main.cpp with the mechanism calls left out, since only the drivetrain is
+ * simulated; keep them in sync when a routine changes. The field is not simulated either. When a routine drives into a
+ * matchloader or goal and resets its pose, the robot is moved along its heading to where the reset says it is, which is
+ * what the wall does on the real field, and keeps its sideways and heading error.
+ *
+ * Differences from the robot that remain:
+ * - kachow's moveToPoint is its own port only once a latency has been measured and saved on the SD card, otherwise it
+ *   is LemLib's. The simulation has no latency, and with none the port drives like LemLib's, so LemLib's is used
+ * - the schedule is the one in main.cpp. On a robot that has been autotuned, loadTunedGains replaces it with the saved
+ *   angular gains, so copy those in below to check the robot as it is
+ * - --lemlib-turns runs LemLib's turnToHeading instead, to see what the scheduled turns change
+ *
+ * @code
+ * g++ -std=c++20 -O2 -pthread -Iinclude tools/autonMonteCarlo.cpp src/kachow/gainSchedule.cpp -o bin/autonMonteCarlo
+ * bin/autonMonteCarlo
+ * bin/autonMonteCarlo --routine skills --runs 5000 --scale 2
+ * @endcode
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "driveSim.hpp"
+#include "kachow/gainSchedule.hpp"
+#include "lemlibSim.hpp"
+
+namespace {
+constexpr float dt = 0.01;
+
+// controller settings from main.cpp
+constexpr sim::ControllerSettings lateralSettings {7, 0, 6, 3, 1, 100, 3, 500, 0};
+constexpr sim::ControllerSettings angularSettings {1.8, 0, 10, 3, 1, 100, 3, 500, 0};
+// angularSchedule from main.cpp
+const kachow::GainSchedule angularSchedule({10, 45, 180}, {0, 300},
+                                           {{1.8, 0, 10}, {1.8, 0, 10}, {1.8, 0, 10}, {1.8, 0, 10}, {1.8, 0, 10},
+                                            {1.8, 0, 10}});
+// run LemLib's turnToHeading instead of the scheduled one, set from the command line before any runs start
+bool lemlibTurns = false;
+
+/**
+ * @brief kachow::Chassis::turnToHeading with an angular schedule, one iteration at a time like sim::Motion
+ *
+ * The routines only turn the short way, and the simulation has no latency, so this leaves out forced directions and
+ * the control pose.
+ */
+class ScheduledTurn {
+    public:
+        /**
+         * @param theta compass degrees
+         */
+        ScheduledTurn(float theta, int timeout, sim::MotionParams params)
+            : targetTheta(theta),
+              timeout(timeout),
+              params(params),
+              pid(angularSchedule, angularSettings.windupRange, true),
+              smallExit(angularSettings.smallError, angularSettings.smallErrorTimeout),
+              largeExit(angularSettings.largeError, angularSettings.largeErrorTimeout) {}
+
+        bool update(const sim::Pose& pose, float& left, float& right) {
+            const int now = elapsed;
+            elapsed += 10;
+            if (now >= timeout || smallExit.getExit() || largeExit.getExit()) return false;
+            // compass degrees, clockwise positive
+            const float heading = 90 - pose.theta * 180 / M_PI;
+            // degrees per second, from the change in heading since the last iteration
+            const float velocity = now == 0 ? 0 : std::remainder(heading - prevHeading, 360.0f) * 100;
+            prevHeading = heading;
+
+            const float error = std::remainder(targetTheta - heading, 360.0f);
+            if (now != 0 && std::signbit(error) != std::signbit(prevError) && std::fabs(error) < 90) settling = true;
+            prevError = error;
+            if (params.minSpeed != 0 && (std::fabs(error) < params.earlyExitRange || settling)) return false;
+            smallExit.update(error, now);
+            largeExit.update(error, now);
+
+            float output = pid.update(error, velocity);
+            output = std::clamp(output, -params.maxSpeed, params.maxSpeed);
+            if (!settling) output = sim::slew(output, prevOutput, angularSettings.slew);
+            if (params.minSpeed != 0 && std::fabs(output) < params.minSpeed) {
+                output = output < 0 ? -params.minSpeed : params.minSpeed;
+            }
+            prevOutput = output;
+            left = output;
+            right = -output;
+            return true;
+        }
+    private:
+        float targetTheta;
+        int timeout;
+        sim::MotionParams params;
+        kachow::ScheduledPID pid;
+        sim::ExitCondition smallExit, largeExit;
+        int elapsed = 0;
+        float prevHeading = 0;
+        float prevError = 0;
+        float prevOutput = 0;
+        bool settling = false;
+};
+
+enum class StepType { SET_POSE, RELOCALIZE, POINT, POSE, TURN, DELAY, WAIT, SCORE };
+
+struct Step {
+        StepType type;
+        float x = 0, y = 0, theta = 0;
+        int time = 0;
+        sim::MotionParams params {};
+        const char* label = nullptr;
+};
+
+// steps named after the calls they stand for in main.cpp
+
+// chassis.setPose at the start of a routine
+Step setPose(float x, float y, float theta) { return {StepType::SET_POSE, x, y, theta}; }
+
+// chassis.setPose(x, y, chassis.getPose().theta) after driving into a wall, matchloader or goal
+Step relocalize(float x, float y) { return {StepType::RELOCALIZE, x, y}; }
+
+Step point(float x, float y, int timeout, sim::MotionParams params = {}) {
+    return {StepType::POINT, x, y, 0, timeout, params};
+}
+
+Step pose(float x, float y, float theta, int timeout, sim::MotionParams params = {}) {
+    return {StepType::POSE, x, y, theta, timeout, params};
+}
+
+Step turn(float theta, int timeout, sim::MotionParams params = {}) {
+    return {StepType::TURN, 0, 0, theta, timeout, params};
+}
+
+// pros::delay
+Step delay(int time) { return {StepType::DELAY, 0, 0, 0, time}; }
+
+// chassis.waitUntilDone
+Step wait() { return {StepType::WAIT}; }
+
+// where the robot is at the end of the motion that is running, or now if none is
+Step score(const char* label) { return {StepType::SCORE, 0, 0, 0, 0, {}, label}; }
+
+struct Routine {
+        const char* name;
+        std::vector<Step> steps;
+};
+
+const std::vector<Routine> routines = {
+    {"AWP",
+     {
+         setPose(88.25, 24.75, 90),
+         point(120.2, 24.75, 1500, {.minSpeed = 60, .earlyExitRange = 9}),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 10}),
+         point(120.8, -20, 1400, {.maxSpeed = 80}), // first matchloader
+         wait(),
+         relocalize(119, 14.5),
+         score("first matchloader"),
+         point(118.5, 50, 3000, {.forwards = false, .maxSpeed = 90, .earlyExitRange = 4}), // first long goal
+         delay(450),
+         wait(),
+         relocalize(120, 43.5),
+         score("first long goal"),
+         point(120, 32, 2000, {.minSpeed = 60, .earlyExitRange = 4}),
+         delay(100),
+         turn(-40, 1500, {.minSpeed = 30, .earlyExitRange = 110}),
+         point(92, 46, 2000, {.minSpeed = 60, .earlyExitRange = 4}), // first set of balls
+         score("first balls"),
+         delay(800),
+         delay(100),
+         turn(-90, 800, {.minSpeed = 30, .earlyExitRange = 10}),
+         point(48, 45, 2500, {.minSpeed = 60, .earlyExitRange = 4}), // second set of balls
+         score("second balls"),
+         delay(800),
+         turn(-135, 1000, {.minSpeed = 30, .earlyExitRange = 80}),
+         point(59, 55, 1500, {.forwards = false}), // middle goal
+         score("middle goal"),
+         delay(750),
+         delay(2000),
+         point(26, 24, 2000, {.minSpeed = 60, .earlyExitRange = 4}),
+         delay(500),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 10}),
+         point(25.2, -20, 1600, {.maxSpeed = 80}), // second matchloader
+         wait(),
+         relocalize(25, 14.5),
+         score("second matchloader"),
+         point(25.5, 50, 1800, {.forwards = false, .maxSpeed = 90, .earlyExitRange = 4}), // second long goal
+         delay(300),
+         delay(350),
+         wait(),
+         score("second long goal"),
+     }},
+    {"right7ball",
+     {
+         setPose(79, 25, 0),
+         point(101, 50.5, 2000, {.minSpeed = 60, .earlyExitRange = 1}),
+         score("balls"),
+         turn(135, 1000, {.minSpeed = 50, .earlyExitRange = 10}),
+         point(124, 24, 2000, {.minSpeed = 60, .earlyExitRange = 6}),
+         delay(400),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 20}),
+         point(123.8, -20, 1100, {.maxSpeed = 80}), // matchloader
+         wait(),
+         relocalize(119, 14.5),
+         score("matchloader"),
+         point(118.5, 50, 2700, {.forwards = false, .maxSpeed = 90, .earlyExitRange = 4}), // long goal
+         delay(650),
+         wait(),
+         relocalize(120, 43.5),
+         score("long goal"),
+         pose(112, 30, 150, 3500, {.minSpeed = 60, .earlyExitRange = 4}),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 20}),
+         point(113, 62, 2000, {.forwards = false, .maxSpeed = 70}),
+         score("final push"),
+     }},
+    {"left4plus3",
+     {
+         setPose(65, 25, 0),
+         point(48, 48, 2000, {.minSpeed = 60, .earlyExitRange = 1}),
+         score("balls"),
+         turn(-135, 1000, {.minSpeed = 50, .earlyExitRange = 80}),
+         point(61.5, 58.5, 1500, {.forwards = false}), // middle goal
+         score("middle goal"),
+         delay(800),
+         delay(1500),
+         point(26, 24, 2000, {.minSpeed = 60, .earlyExitRange = 6}),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 20}),
+         point(26.2, -20, 1300, {.maxSpeed = 80}), // matchloader
+         wait(),
+         relocalize(25.5, 14.5),
+         score("matchloader"),
+         point(27, 50, 1800, {.forwards = false, .maxSpeed = 90, .earlyExitRange = 4}), // long goal
+         delay(300),
+         delay(350),
+         wait(),
+         relocalize(24, 43.5),
+         score("long goal"),
+         pose(13, 28, 210, 3000, {.minSpeed = 60, .earlyExitRange = 4}),
+         turn(180, 800, {.minSpeed = 50, .earlyExitRange = 20}),
+         point(15, 63, 2000, {.forwards = false, .maxSpeed = 70}),
+         score("final push"),
+     }},
+    {"skills",
+     {
+         setPose(55.75, 24.75, -90),
+         point(25, 24.75, 1500),
+         turn(180, 800),
+         point(24.5, -20, 2500, {.maxSpeed = 60}),
+         wait(),
+         relocalize(24, 14.5),
+         score("matchloader 1"),
+         point(24, 22, 1500, {.forwards = false}),
+         pose(14.5, 36, 180, 2200, {.forwards = false}),
+         delay(600),
+         point(14.5, 96, 4000, {.forwards = false, .maxSpeed = 70}), // hits the wall here
+         pose(26.5, 120, 240, 2000, {.forwards = false}),
+         wait(),
+         turn(0, 900),
+         point(25.5, 80, 1000, {.forwards = false, .maxSpeed = 70}),
+         wait(),
+         relocalize(28, 102),
+         score("long goal 1"),
+         delay(4500),
+         point(28, 164, 3500, {.maxSpeed = 60}),
+         wait(),
+         relocalize(28, 129.5),
+         score("matchloader 2"),
+         point(28, 94, 2200, {.forwards = false, .maxSpeed = 70, .earlyExitRange = 4}),
+         delay(600),
+         delay(4000),
+         wait(),
+         relocalize(24, 100.5),
+         score("long goal 2"),
+         point(24, 110, 1500),
+         turn(90, 800),
+         point(119, 115, 4000, {.maxSpeed = 70}),
+         score("across the field"),
+         turn(0, 800),
+         point(119, 164, 3500, {.maxSpeed = 60}), // matchloader 3
+         wait(),
+         relocalize(120, 129.5),
+         score("matchloader 3"),
+         point(120, 122, 1500, {.forwards = false}),
+         pose(132.5, 108, 0, 2200, {.forwards = false}),
+         delay(600),
+         pose(132.5, 46, 0, 4000, {.forwards = false}),
+         pose(120.5, 25, 60, 2000, {.forwards = false}),
+         wait(),
+         turn(180, 900),
+         point(119.5, 64, 1000, {.forwards = false}),
+         wait(),
+         relocalize(114, 42),
+         score("long goal 3"),
+         delay(4500),
+         point(114, -20, 3500, {.maxSpeed = 60}),
+         wait(),
+         relocalize(116, 14.5),
+         score("matchloader 4"),
+         point(116, 50, 3200, {.forwards = false, .maxSpeed = 70, .earlyExitRange = 4}),
+         delay(600),
+         wait(),
+         relocalize(120, 43.5),
+         score("long goal 4"),
+         point(120, 20, 2000),
+         turn(70, 1200),
+         point(60, 4, 4000, {.forwards = false, .minSpeed = 127}),
+         score("park"),
+     }},
+};
+
+/** how much each run is perturbed, all standard deviations unless noted */
+struct Perturbation {
+        /** starting position, inches */
+        float startPosition = 0.5;
+        /** starting heading, degrees */
+        float startHeading = 1;
+        /** wheel diameter, as a fraction of nominal, each side on its own */
+        float wheelDiameter = 0.01;
+        /** IMU drift, degrees per minute */
+        float imuDrift = 1;
+        /** IMU scale error, as a fraction */
+        float imuScale = 0.003;
+        /** battery voltage, spread evenly between these */
+        float batteryLow = 11.8, batteryHigh = 12.9;
+        /** strength of each side, from motor wear and friction, as a fraction */
+        float motorStrength = 0.03;
+};
+
+// speed is in proportion to battery voltage, and the unperturbed run has this much
+constexpr float nominalBattery = 12.4;
+
+struct PoseError {
+        float position;
+        float heading;
+};
+
+struct RunResult {
+        /** ms */
+        int completionTime;
+        /** true pose at each scoring point */
+        std::vector<sim::Pose> scores;
+};
+
+class Run {
+    public:
+        Run(const Routine& routine, const Perturbation& p, float scale, std::mt19937* rng)
+            : routine(routine) {
+            if (rng == nullptr) return;
+            std::normal_distribution<float> normal(0, 1);
+            std::uniform_real_distribution<float> uniform(0, 1);
+            startOffset = {normal(*rng) * p.startPosition * scale, normal(*rng) * p.startPosition * scale,
+                           float(normal(*rng) * p.startHeading * scale * M_PI / 180)};
+            leftDiameter = 1 + normal(*rng) * p.wheelDiameter * scale;
+            rightDiameter = 1 + normal(*rng) * p.wheelDiameter * scale;
+            imuDrift = normal(*rng) * p.imuDrift * scale * M_PI / 180 / 60000;
+            imuScale = normal(*rng) * p.imuScale * scale;
+            const float battery = nominalBattery + (p.batteryLow + (p.batteryHigh - p.batteryLow) * uniform(*rng) -
+                                                    nominalBattery) *
+                                                       scale;
+            // a bigger wheel covers more ground for the same motor speed
+            robot.settings.leftScale =
+                leftDiameter * battery / nominalBattery * (1 + normal(*rng) * p.motorStrength * scale);
+            robot.settings.rightScale =
+                rightDiameter * battery / nominalBattery * (1 + normal(*rng) * p.motorStrength * scale);
+        }
+
+        RunResult run() {
+            for (const Step& step : routine.steps) {
+                switch (step.type) {
+                    case StepType::SET_POSE: {
+                        const float theta = M_PI_2 - step.theta * M_PI / 180;
+                        robot.setPose(step.x + startOffset.x, step.y + startOffset.y, theta + startOffset.theta);
+                        startTheta = robot.theta;
+                        odom = {step.x, step.y, theta};
+                        headingOffset = theta;
+                        break;
+                    }
+                    case StepType::RELOCALIZE: relocalize(step.x, step.y); break;
+                    case StepType::POINT:
+                    case StepType::POSE:
+                    case StepType::TURN: {
+                        while (motion) tick();
+                        if (step.type == StepType::TURN && !lemlibTurns) {
+                            motion.emplace(std::in_place_type<ScheduledTurn>, step.theta, step.time, step.params);
+                            break;
+                        }
+                        const sim::MotionType type = step.type == StepType::POINT ? sim::MotionType::POINT
+                                                     : step.type == StepType::POSE ? sim::MotionType::POSE
+                                                                                   : sim::MotionType::TURN;
+                        motion.emplace(std::in_place_type<sim::Motion>, type, step.x, step.y, step.theta, step.time,
+                                       step.params, lateralSettings, angularSettings);
+                        break;
+                    }
+                    case StepType::DELAY:
+                        for (int t = 0; t < step.time; t += 10) tick();
+                        break;
+                    case StepType::WAIT:
+                        while (motion) tick();
+                        break;
+                    case StepType::SCORE:
+                        if (motion) scorePending = true;
+                        else result.scores.push_back({robot.x, robot.y, robot.theta});
+                        break;
+                }
+            }
+            while (motion) tick();
+            result.completionTime = time;
+            return result;
+        }
+    private:
+        void tick() {
+            float left = 0, right = 0;
+            if (motion && !std::visit([&](auto& active) { return active.update(odom, left, right); }, *motion)) {
+                motion.reset();
+                left = right = 0;
+                if (scorePending) result.scores.push_back({robot.x, robot.y, robot.theta});
+                scorePending = false;
+            }
+            const float leftBefore = robot.leftDistance, rightBefore = robot.rightDistance;
+            robot.step(left, right, dt);
+            time += 10;
+
+            // the encoders think the wheels are nominal size
+            const float leftTurned = (robot.leftDistance - leftBefore) / leftDiameter;
+            const float rightTurned = (robot.rightDistance - rightBefore) / rightDiameter;
+            const float forward = (leftTurned + rightTurned) / 2;
+            const float theta = headingOffset + imuHeading();
+            odom.x += forward * std::cos((odom.theta + theta) / 2);
+            odom.y += forward * std::sin((odom.theta + theta) / 2);
+            odom.theta = theta;
+        }
+
+        // heading change the IMU has measured since the start
+        float imuHeading() const { return (robot.theta - startTheta) * (1 + imuScale) + imuDrift * time; }
+
+        // the wall stops the robot where the pose reset says, along its heading; any sideways error stays
+        void relocalize(float x, float y) {
+            const float cos = std::cos(robot.theta), sin = std::sin(robot.theta);
+            const float along = (x - robot.x) * cos + (y - robot.y) * sin;
+            robot.x += along * cos;
+            robot.y += along * sin;
+            odom.x = x;
+            odom.y = y;
+        }
+
+        const Routine& routine;
+        sim::DriveSim robot;
+        sim::Pose startOffset {0, 0, 0};
+        float leftDiameter = 1, rightDiameter = 1;
+        float imuDrift = 0, imuScale = 0;
+        float startTheta = 0;
+        float headingOffset = 0;
+        sim::Pose odom {0, 0, 0};
+        std::optional<std::variant<sim::Motion, ScheduledTurn>> motion;
+        bool scorePending = false;
+        int time = 0;
+        RunResult result {};
+};
+
+float percentile(std::vector<float> values, float fraction) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, size_t(fraction * (values.size() - 1) + 0.5f))];
+}
+
+float mean(const std::vector<float>& values) {
+    float sum = 0;
+    for (float value : values) sum += value;
+    return values.empty() ? 0 : sum / values.size();
+}
+
+void evaluate(const Routine& routine, int runs, unsigned threads, const Perturbation& perturbation, float scale) {
+    const RunResult nominal = Run(routine, perturbation, 0, nullptr).run();
+    std::vector<RunResult> results(runs);
+    std::atomic<int> next = 0;
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back([&] {
+            for (int j = next++; j < runs; j = next++) {
+                std::mt19937 rng(j);
+                results[j] = Run(routine, perturbation, scale, &rng).run();
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    std::vector<float> times;
+    for (const RunResult& result : results) times.push_back(result.completionTime / 1000.0f);
+    printf("\n%s: %d runs, %.2fs unperturbed\n", routine.name, runs, nominal.completionTime / 1000.0f);
+    printf("  %-20s %8s %8s %8s %8s %8s\n", "", "mean", "p5", "p50", "p95", "max");
+    printf("  %-20s %7.2fs %7.2fs %7.2fs %7.2fs %7.2fs\n", "completion time", mean(times), percentile(times, 0.05),
+           percentile(times, 0.5), percentile(times, 0.95), percentile(times, 1));
+    printf("  %-20s %8s %8s %8s %8s %8s %10s\n", "scoring point error", "mean", "p5", "p50", "p95", "max",
+           "p95 head");
+
+    size_t label = 0;
+    for (const Step& step : routine.steps) {
+        if (step.type != StepType::SCORE) continue;
+        const sim::Pose& expected = nominal.scores[label];
+        std::vector<float> position, heading;
+        for (const RunResult& result : results) {
+            const sim::Pose& actual = result.scores[label];
+            position.push_back(std::hypot(actual.x - expected.x, actual.y - expected.y));
+            heading.push_back(std::fabs(sim::angleError(actual.theta, expected.theta)) * 180 / M_PI);
+        }
+        printf("  %-20s %6.2fin %6.2fin %6.2fin %6.2fin %6.2fin %7.1fdeg\n", step.label, mean(position),
+               percentile(position, 0.05), percentile(position, 0.5), percentile(position, 0.95),
+               percentile(position, 1), percentile(heading, 0.95));
+        label++;
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int runs = 2000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    float scale = 1;
+    const char* only = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--runs") && hasValue) runs = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--threads") && hasValue) threads = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--scale") && hasValue) scale = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--routine") && hasValue) only = argv[++i];
+        else if (!strcmp(argv[i], "--lemlib-turns")) lemlibTurns = true;
+        else {
+            fprintf(stderr, "usage: autonMonteCarlo [--runs n] [--threads n] [--scale perturbation multiplier]\n"
+                            "                       [--routine AWP | right7ball | left4plus3 | skills]\n"
+                            "                       [--lemlib-turns]\n");
+            return 1;
+        }
+    }
+
+    const Perturbation perturbation;
+    printf("%u threads, perturbations x%.2f, %s turns\n", threads, scale, lemlibTurns ? "LemLib" : "scheduled");
+    for (const Routine& routine : routines) {
+        if (only == nullptr || !strcmp(only, routine.name)) evaluate(routine, runs, threads, perturbation, scale);
+    }
+    return 0;
+}
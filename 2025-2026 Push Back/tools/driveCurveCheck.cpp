@@ -0,0 +1,96 @@
+/**
+ * @file driveCurveCheck.cpp
+ * @brief Host check that kachow::LutDriveCurve matches lemlib::ExpoDriveCurve
+ *
+ * Every joystick value from -127 to 127 is looked up in the table and compared against LemLib's expo curve, worked out
+ * here with std::pow the way LemLib does it. Curves are checked for the boot settings in main.cpp, the extremes the
+ * driver profiles allow, and a table built at compile time. Fractional inputs must land on the nearest table entry,
+ * and inputs past the stick's range must clamp to the ends. Exits with 1 if anything is off by more than --tolerance.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/driveCurveCheck.cpp -o bin/driveCurveCheck
+ * bin/driveCurveCheck
+ * bin/driveCurveCheck --tolerance 0.001
+ * @endcode
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "kachow/lutDriveCurve.hpp"
+
+namespace {
+struct CurveSettings {
+        float deadband;
+        float minOutput;
+        float gain;
+};
+
+// lemlib::ExpoDriveCurve::curve, in floats like LemLib
+float expoReference(float input, CurveSettings settings) {
+    if (std::fabs(input) <= settings.deadband) return 0;
+    const float sign = input < 0 ? -1 : 1;
+    const float g = std::fabs(input) - settings.deadband;
+    const float g127 = 127 - settings.deadband;
+    const float i = std::pow(settings.gain, g - 127) * g * sign;
+    const float i127 = std::pow(settings.gain, g127 - 127) * g127;
+    return (127.0 - settings.minOutput) / 127 * i * 127 / i127 + settings.minOutput * sign;
+}
+
+// largest difference from the reference over the whole stick range
+float worstError(kachow::LutDriveCurve& curve, CurveSettings settings) {
+    float worst = 0;
+    for (int input = -127; input <= 127; input++) {
+        worst = std::max(worst, std::fabs(curve.curve(input) - expoReference(input, settings)));
+    }
+    return worst;
+}
+
+// fractional inputs round to the nearest entry, inputs past the ends clamp
+bool lookupsMatch(kachow::LutDriveCurve& curve) {
+    bool ok = true;
+    for (int input = -126; input <= 126; input++) {
+        ok = ok && curve.curve(input + 0.4f) == curve.curve(input) && curve.curve(input - 0.4f) == curve.curve(input);
+    }
+    return ok && curve.curve(500) == curve.curve(127) && curve.curve(-500) == curve.curve(-127);
+}
+
+// built at compile time, the way main.cpp builds its boot curves
+constinit kachow::LutDriveCurve compiled(3, 5, 1.02);
+} // namespace
+
+int main(int argc, char** argv) {
+    float tolerance = 0.01;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--tolerance out of 127]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const CurveSettings cases[] = {
+        {3, 5, 1.02}, // main.cpp's boot curves
+        {0, 0, 1}, // linear
+        {0, 0, 1.1},
+        {10, 20, 1.019},
+        {20, 0, 1.05},
+        {3, 5, 1.005},
+    };
+    bool ok = true;
+    for (const CurveSettings& settings : cases) {
+        kachow::LutDriveCurve curve(settings.deadband, settings.minOutput, settings.gain);
+        const float error = worstError(curve, settings);
+        const bool rounds = lookupsMatch(curve);
+        printf("deadband %5.1f  min output %5.1f  gain %6.3f  worst error %.6f  rounding %s\n", settings.deadband,
+               settings.minOutput, settings.gain, error, rounds ? "ok" : "WRONG");
+        ok = ok && error <= tolerance && rounds;
+    }
+    const float error = worstError(compiled, cases[0]);
+    printf("compile time table                           worst error %.6f\n", error);
+    ok = ok && error <= tolerance;
+
+    printf(ok ? "all curves match\n" : "MISMATCH\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file driveSim.hpp
+ * @brief Differential drive simulation shared by the host tools
+ *
+ * Each side follows its motor command with a first order lag towards the speed the command asks for, and the robot
+ * moves as a unicycle. That is enough to show overshoot, settling and tracking error with the same units and motor
+ * commands the robot code uses. Header only, so a tool just includes it.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+struct DriveSimSettings {
+        /** inches */
+        float trackWidth = 11.375;
+        /** in/s at a command of 127, 450rpm on 3.25" wheels */
+        float maxSpeed = 450.0f / 60 * M_PI * 3.25f;
+        /** seconds for a side to get 63% of the way to a new speed */
+        float timeConstant = 0.1;
+        /** turning is this much slower than the wheel speeds say, from wheel scrub. 1 for no scrub */
+        float turnEfficiency = 1;
+        /** how fast each side actually runs for a command, from battery, motor wear or wheel size. 1 for nominal */
+        float leftScale = 1;
+        float rightScale = 1;
+};
+
+class DriveSim {
+    public:
+        explicit DriveSim(DriveSimSettings settings = {})
+            : settings(settings) {}
+
+        void setPose(float x, float y, float theta) {
+            this->x = x;
+            this->y = y;
+            this->theta = theta;
+        }
+
+        /**
+         * @brief advance the simulation
+         *
+         * @param left left motor command, -127 to 127
+         * @param right right motor command, -127 to 127
+         * @param dt seconds
+         */
+        void step(float left, float right, float dt) {
+            const float alpha = 1 - std::exp(-dt / settings.timeConstant);
+            const float top = settings.maxSpeed / 127;
+            const float leftTarget = std::clamp(left, -127.0f, 127.0f) * top * settings.leftScale;
+            const float rightTarget = std::clamp(right, -127.0f, 127.0f) * top * settings.rightScale;
+            leftVel += (leftTarget - leftVel) * alpha;
+            rightVel += (rightTarget - rightVel) * alpha;
+            const float forward = (leftVel + rightVel) / 2 * dt;
+            const float turn = (rightVel - leftVel) / settings.trackWidth * settings.turnEfficiency * dt;
+            // drive along the arc using the heading halfway through the step
+            x += forward * std::cos(theta + turn / 2);
+            y += forward * std::sin(theta + turn / 2);
+            theta += turn;
+            leftDistance += leftVel * dt;
+            rightDistance += rightVel * dt;
+        }
+
+        /** inches */
+        float x = 0;
+        float y = 0;
+        /** radians, standard position */
+        float theta = 0;
+        /** in/s */
+        float leftVel = 0;
+        float rightVel = 0;
+        /** how far each side has driven, like a drive encoder, in inches */
+        float leftDistance = 0;
+        float rightDistance = 0;
+        DriveSimSettings settings;
+};
+} // namespace sim
@@ -0,0 +1,190 @@
+/**
+ * @file ekfReplay.cpp
+ * @brief Runs kachow::PoseEkf on a computer, against a recording from the robot or a simulated drive
+ *
+ * With a CSV recorded by FusedOdometry::startRecording, every step is fed back through the filter with the time step,
+ * slip and wall or GPS fixes it had on the robot, and the filtered pose is printed next to the pose LemLib had at the
+ * time, so noise settings can be tried without the robot.
+ *
+ * With no file, a robot is driven around the field on sim::DriveSim, with full power launches and stops. The wheels
+ * follow the motors, but the ground can only push the robot so hard, so the drive wheels spin past the ground when
+ * they accelerate faster than that and the drive encoders over-count. The filter is compared against plain odometry
+ * (drive encoders and IMU, like LemLib without a vertical tracking wheel) and the real pose. The filter's reported
+ * position error should cover the real error most of the time; if the real error is often outside it, the noise
+ * settings are too optimistic.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/ekfReplay.cpp src/kachow/ekf.cpp src/kachow/geometryCalibration.cpp \
+ *     src/kachow/config.cpp -o bin/ekfReplay
+ * bin/ekfReplay
+ * bin/ekfReplay --gps --grip 400
+ * bin/ekfReplay ekf.csv --track-width 11.375 --offset -1.5
+ * @endcode
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "kachow/ekf.hpp"
+#include "kachow/geometryCalibration.hpp"
+#include "driveSim.hpp"
+
+namespace {
+constexpr float dt = 0.01;
+
+int replay(const char* path, float trackWidth, float offset) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    char line[512];
+    // header
+    if (fgets(line, sizeof(line), file) == nullptr) return 1;
+
+    kachow::PoseEkf ekf(trackWidth, offset);
+    bool first = true;
+    int steps = 0, fixes = 0;
+    float maxDifference = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        unsigned time;
+        kachow::OdometryStep step;
+        float fixX, fixY, fixError, gpsX, gpsY, gpsError, x, y, theta;
+        if (sscanf(line, "%u,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f", &time, &step.dt, &step.left, &step.right,
+                   &step.lateral, &step.headingChange, &step.slip, &fixX, &fixY, &fixError, &gpsX, &gpsY, &gpsError, &x,
+                   &y, &theta) != 16)
+            continue;
+        if (first) {
+            ekf.reset(x, y, theta * M_PI / 180);
+            first = false;
+            continue;
+        }
+        // in the order FusedOdometry took them: a wall fix, the step, then the GPS
+        if (std::isfinite(fixError)) {
+            ekf.updatePosition(fixX, fixY, fixError);
+            fixes++;
+        }
+        ekf.predict(step);
+        if (std::isfinite(gpsX)) {
+            ekf.updatePosition(gpsX, gpsY, gpsError);
+            fixes++;
+        }
+        const float difference = std::hypot(ekf.getX() - x, ekf.getY() - y);
+        if (difference > maxDifference) maxDifference = difference;
+        if (steps++ % 50 == 0) {
+            printf("%7.2fs  lemlib %7.2f %7.2f %7.1f  ekf %7.2f %7.2f %7.1f  ±%.2fin ±%.2fdeg  slip %.2f\n",
+                   time / 1000.0f, x, y, theta, ekf.getX(), ekf.getY(), ekf.getTheta() * 180 / M_PI,
+                   ekf.positionError(), ekf.headingError(), ekf.getSlip());
+        }
+    }
+    fclose(file);
+    printf("%d steps, %d fixes, filter and LemLib differed by up to %.2fin\n", steps, fixes, maxDifference);
+    return 0;
+}
+
+// one leg of the simulated drive: motor commands held for a time
+struct Leg {
+        float left;
+        float right;
+        float time;
+};
+
+int simulate(bool withGps, float grip, unsigned seed) {
+    // the motors and wheels. Its pose is not used, the ground decides where the robot goes
+    sim::DriveSim wheels;
+    const float trackWidth = wheels.settings.trackWidth;
+    // standard position, facing up the field
+    float x = 36, y = 24, theta = M_PI / 2;
+    float leftGround = 0, rightGround = 0;
+    const Leg legs[] = {{127, 127, 0.9}, {60, -60, 0.4}, {0, 0, 0.3},      {127, 127, 0.7}, {-40, 40, 0.5},
+                        {80, 127, 0.5},  {0, 0, 0.4},    {-127, -127, 0.6}, {0, 0, 0.5}};
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0, 1);
+    // where main.cpp's tracking wheel is
+    const float trackingOffset = -1.5;
+    kachow::PoseEkf ekf(trackWidth, trackingOffset);
+    ekf.reset(x, y, M_PI / 2 - theta);
+    // plain odometry, compass frame
+    float odomX = x, odomY = y;
+    float odomTheta = M_PI / 2 - theta;
+
+    float time = 0, worstEkf = 0, worstOdom = 0;
+    int steps = 0, covered = 0;
+    printf("  time   true x  true y   odom err   ekf err   ±ekf   slip\n");
+    for (const Leg& leg : legs) {
+        for (float t = 0; t < leg.time; t += dt, time += dt) {
+            wheels.step(leg.left, leg.right, dt);
+            // each side of the robot follows its wheels only as fast as the grip allows
+            const float maxChange = grip * dt;
+            leftGround += std::clamp(wheels.leftVel - leftGround, -maxChange, maxChange);
+            rightGround += std::clamp(wheels.rightVel - rightGround, -maxChange, maxChange);
+            const float forward = (leftGround + rightGround) / 2 * dt;
+            const float turn = (rightGround - leftGround) / trackWidth * dt;
+            x += forward * std::cos(theta + turn / 2);
+            y += forward * std::sin(theta + turn / 2);
+            theta += turn;
+
+            kachow::OdometryStep step;
+            // the encoders count the wheels, not the ground
+            step.left = wheels.leftVel * dt;
+            step.right = wheels.rightVel * dt;
+            // the robot does not move sideways in the simulation, so the tracking wheel only rolls with the turns
+            step.lateral = kachow::spinRoll(trackingOffset, -turn) + 0.002f * normal(rng);
+            step.headingChange = -turn + 0.0002f * normal(rng);
+            step.dt = dt;
+
+            const float odomForward = (step.left + step.right) / 2;
+            odomX += odomForward * std::sin(odomTheta + step.headingChange / 2);
+            odomY += odomForward * std::cos(odomTheta + step.headingChange / 2);
+            odomTheta += step.headingChange;
+
+            ekf.predict(step);
+            // a GPS fix every 50ms, 1in of noise
+            if (withGps && steps % 5 == 0) {
+                ekf.updatePosition(x + normal(rng), y + normal(rng), 1);
+            }
+
+            const float ekfError = std::hypot(ekf.getX() - x, ekf.getY() - y);
+            const float odomError = std::hypot(odomX - x, odomY - y);
+            worstEkf = std::fmax(worstEkf, ekfError);
+            worstOdom = std::fmax(worstOdom, odomError);
+            // 2 standard deviations of the least certain direction
+            if (ekfError <= 2 * ekf.positionError()) covered++;
+            if (steps++ % 25 == 0) {
+                printf("%6.2fs  %7.2f %7.2f  %8.2fin %8.2fin %6.2fin  %.2f\n", time, x, y, odomError,
+                       ekfError, ekf.positionError(), ekf.getSlip());
+            }
+        }
+    }
+    printf("worst error: odometry %.2fin, filter %.2fin\n", worstOdom, worstEkf);
+    printf("real error inside the filter's 2 sigma %.0f%% of the time\n", 100.0f * covered / steps);
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    float trackWidth = 11.375, offset = -1.5;
+    float grip = 250;
+    bool withGps = false;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--track-width") && i + 1 < argc) trackWidth = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--offset") && i + 1 < argc) offset = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--gps")) withGps = true;
+        else if (!strcmp(argv[i], "--grip") && i + 1 < argc) grip = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = atoi(argv[++i]);
+        else if (argv[i][0] != '-') path = argv[i];
+        else {
+            fprintf(stderr,
+                    "usage: %s [recording.csv] [--track-width in] [--offset in] [--gps] [--grip in/s²] [--seed n]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (path != nullptr) return replay(path, trackWidth, offset);
+    return simulate(withGps, grip, seed);
+}
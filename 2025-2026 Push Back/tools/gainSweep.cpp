@@ -0,0 +1,279 @@
+/**
+ * @file gainSweep.cpp
+ * @brief Host search for lemlib::ControllerSettings against the drivetrain simulation
+ *
+ * Runs every candidate set of gains and exit ranges through a standard suite of motions with LemLib's own moveToPoint
+ * and turnToHeading from lemlibSim.hpp: a 6in and a 48in move for the lateral controller, and a 90 and a 180 degree
+ * turn for the angular controller. Each candidate is scored by its total settle time over the suite (how long until the
+ * exit conditions end the motion) and its worst overshoot. Candidates that end a motion further off than --accuracy are
+ * thrown out, since exiting early on the large error range is not a real win.
+ *
+ * The search starts with a coarse grid and then refines around the best candidates for a few rounds, on all cores. The
+ * output is the Pareto front: every candidate that no other candidate beats on both settle time and overshoot. Pick a
+ * point on it and start tuning on the robot from there instead of from zero. The current gains from main.cpp are scored
+ * too, for comparison.
+ *
+ * The simulation has no sensor noise or latency and a perfectly symmetric drivetrain, so expect the robot to want
+ * softer gains than the front suggests. --time-constant and --scrub bring the simulation closer to the real robot.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -pthread -Iinclude tools/gainSweep.cpp -o bin/gainSweep
+ * bin/gainSweep
+ * bin/gainSweep --angular --scrub 0.8 --csv angular.csv
+ * @endcode
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "driveSim.hpp"
+#include "lemlibSim.hpp"
+
+namespace {
+constexpr float dt = 0.01;
+// how long each motion in the suite may take, in ms
+constexpr int timeout = 3000;
+// how long to let the robot coast after a motion exits, so drift past the target counts as overshoot
+constexpr int coastTime = 300;
+
+using Settings = sim::ControllerSettings;
+
+// gains from main.cpp
+constexpr Settings currentLateral {7, 0, 6, 3, 1, 100, 3, 500, 0};
+constexpr Settings currentAngular {1.8, 0, 10, 3, 1, 100, 3, 500, 0};
+
+struct Score {
+        Settings settings;
+        /** total time to exit over the suite, in ms */
+        int settleTime;
+        /** worst overshoot over the suite, in inches or degrees */
+        float overshoot;
+        /** worst final error over the suite, in inches or degrees */
+        float finalError;
+};
+
+struct Result {
+        int settleTime;
+        float overshoot;
+        float finalError;
+};
+
+/**
+ * run one motion to completion with the candidate settings and the current gains for the other controller
+ *
+ * @param lateral true for a moveToPoint of size inches straight ahead, false for a turnToHeading of size degrees
+ * clockwise
+ */
+Result run(const Settings& s, bool lateral, float size, const sim::DriveSimSettings& simSettings) {
+    sim::DriveSim robot(simSettings);
+    // facing along x, 90 degrees on the compass
+    sim::Motion motion(lateral ? sim::MotionType::POINT : sim::MotionType::TURN, size, 0, 90 + size, timeout, {},
+                       lateral ? s : currentLateral, lateral ? currentAngular : s);
+    // progress towards the target, in inches or degrees
+    const auto position = [&] { return lateral ? robot.x : float(-robot.theta * 180 / M_PI); };
+
+    Result result {timeout, 0, 0};
+    float left, right;
+    while (motion.update({robot.x, robot.y, robot.theta}, left, right)) {
+        robot.step(left, right, dt);
+        result.overshoot = std::fmax(result.overshoot, position() - size);
+    }
+    result.settleTime = std::min(motion.getElapsed() - 10, timeout);
+    for (int t = 0; t < coastTime; t += 10) {
+        robot.step(0, 0, dt);
+        result.overshoot = std::fmax(result.overshoot, position() - size);
+    }
+    result.finalError = std::fabs(size - position());
+    return result;
+}
+
+Score evaluate(const Settings& s, bool lateral, const sim::DriveSimSettings& simSettings) {
+    static constexpr float moves[] = {6, 48};
+    static constexpr float turns[] = {90, 180};
+    Score score {s, 0, 0, 0};
+    for (float size : lateral ? moves : turns) {
+        const Result result = run(s, lateral, size, simSettings);
+        score.settleTime += result.settleTime;
+        score.overshoot = std::fmax(score.overshoot, result.overshoot);
+        score.finalError = std::fmax(score.finalError, result.finalError);
+    }
+    return score;
+}
+
+// evaluate every candidate, splitting the work over the threads
+std::vector<Score> evaluateAll(const std::vector<Settings>& candidates, bool lateral,
+                               const sim::DriveSimSettings& simSettings, unsigned threads) {
+    std::vector<Score> scores(candidates.size());
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back([&] {
+            for (size_t j = next++; j < candidates.size(); j = next++)
+                scores[j] = evaluate(candidates[j], lateral, simSettings);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    return scores;
+}
+
+// candidates no other candidate beats on both settle time and overshoot, fastest first
+std::vector<Score> paretoFront(std::vector<Score> scores, float accuracy) {
+    std::erase_if(scores, [&](const Score& score) { return score.finalError > accuracy; });
+    std::sort(scores.begin(), scores.end(), [](const Score& a, const Score& b) {
+        return a.settleTime != b.settleTime ? a.settleTime < b.settleTime : a.overshoot < b.overshoot;
+    });
+    // sorted by settle time, so a candidate is on the front if it overshoots less than everything faster. Ties keep the
+    // first one found
+    std::vector<Score> front;
+    for (const Score& score : scores) {
+        if (front.empty() || score.overshoot < front.back().overshoot) front.push_back(score);
+    }
+    return front;
+}
+
+std::vector<float> range(float from, float to, int steps) {
+    std::vector<float> values;
+    for (int i = 0; i < steps; i++) values.push_back(steps == 1 ? from : from + (to - from) * i / (steps - 1));
+    return values;
+}
+
+std::vector<Settings> grid(bool lateral, int steps) {
+    const std::vector<float> kPs = lateral ? range(2, 24, steps) : range(0.5, 20, steps);
+    const std::vector<float> kDs = range(0, 80, steps);
+    std::vector<Settings> candidates;
+    for (float kP : kPs)
+        for (float kD : kDs)
+            for (float kI : {0.0f, kP / 50})
+                // the windup range only matters with an integral
+                for (float windupRange : kI == 0 ? std::vector<float> {3} : std::vector<float> {1, 3, 6})
+                    for (float smallError : {0.5f, 1.0f, 2.0f})
+                        for (float largeError : {3.0f, 5.0f})
+                            for (float largeErrorTimeout : {300.0f, 500.0f})
+                                candidates.push_back({kP, kI, kD, windupRange, smallError, 100, largeError,
+                                                      largeErrorTimeout, 0});
+    return candidates;
+}
+
+// new candidates near the given ones, with gains scaled by up to about 25% either way
+std::vector<Settings> refine(const std::vector<Score>& around, int count, std::mt19937& rng) {
+    std::lognormal_distribution<float> scale(0, 0.15);
+    std::uniform_int_distribution<int> pick(0, 2);
+    std::vector<Settings> candidates;
+    for (const Score& score : around) {
+        for (int i = 0; i < count; i++) {
+            Settings s = score.settings;
+            s.kP *= scale(rng);
+            s.kI *= scale(rng);
+            s.kD *= scale(rng);
+            s.windupRange *= scale(rng);
+            s.smallError = std::clamp(s.smallError * (0.5f + 0.5f * pick(rng)), 0.25f, s.largeError);
+            s.smallErrorTimeout = std::clamp(s.smallErrorTimeout + 50 * (pick(rng) - 1), 50.0f, 300.0f);
+            s.largeErrorTimeout = std::clamp(s.largeErrorTimeout + 100 * (pick(rng) - 1), 100.0f, 1000.0f);
+            candidates.push_back(s);
+        }
+    }
+    return candidates;
+}
+
+void printHeader() {
+    printf("%8s %8s %8s %8s %8s %8s %8s %8s | %8s %9s %9s\n", "kP", "kI", "kD", "windup", "small", "smallT",
+           "large", "largeT", "settle", "overshoot", "final err");
+}
+
+void print(const Score& score) {
+    const Settings& s = score.settings;
+    printf("%8.3f %8.4f %8.3f %8.2f %8.2f %8.0f %8.2f %8.0f | %6dms %9.2f %9.2f\n", s.kP, s.kI, s.kD, s.windupRange,
+           s.smallError, s.smallErrorTimeout, s.largeError, s.largeErrorTimeout, score.settleTime, score.overshoot,
+           score.finalError);
+}
+
+void writeCsv(FILE* file, const char* controller, const std::vector<Score>& scores) {
+    for (const Score& score : scores) {
+        const Settings& s = score.settings;
+        fprintf(file, "%s,%g,%g,%g,%g,%g,%g,%g,%g,%d,%g,%g\n", controller, s.kP, s.kI, s.kD, s.windupRange,
+                s.smallError, s.smallErrorTimeout, s.largeError, s.largeErrorTimeout, score.settleTime,
+                score.overshoot, score.finalError);
+    }
+}
+
+std::vector<Score> sweep(bool lateral, int steps, int rounds, float accuracy, unsigned threads,
+                         const sim::DriveSimSettings& simSettings) {
+    const char* unit = lateral ? "in" : "deg";
+    printf("\n%s controller, suite %s, accuracy %.2f%s\n", lateral ? "lateral" : "angular",
+           lateral ? "6in and 48in moves" : "90 and 180 degree turns", accuracy, unit);
+
+    const Settings current = lateral ? currentLateral : currentAngular;
+    printf("current gains:\n");
+    printHeader();
+    print(evaluate(current, lateral, simSettings));
+
+    std::vector<Score> all = evaluateAll(grid(lateral, steps), lateral, simSettings, threads);
+    std::vector<Score> front = paretoFront(all, accuracy);
+    std::mt19937 rng(1);
+    for (int round = 0; round < rounds && !front.empty(); round++) {
+        const std::vector<Score> refined = evaluateAll(refine(front, 64, rng), lateral, simSettings, threads);
+        all.insert(all.end(), refined.begin(), refined.end());
+        front = paretoFront(all, accuracy);
+    }
+
+    printf("pareto front, %zu of %zu candidates (settle time in ms over the suite, overshoot and error in %s):\n",
+           front.size(), all.size(), unit);
+    printHeader();
+    for (const Score& score : front) print(score);
+    return front;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    bool lateral = true, angular = true;
+    int steps = 16, rounds = 5;
+    float accuracy = 1;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    const char* csv = nullptr;
+    sim::DriveSimSettings simSettings;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--lateral")) angular = false;
+        else if (!strcmp(argv[i], "--angular")) lateral = false;
+        else if (!strcmp(argv[i], "--steps") && hasValue) steps = std::max(2, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--rounds") && hasValue) rounds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--accuracy") && hasValue) accuracy = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && hasValue) threads = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--time-constant") && hasValue) simSettings.timeConstant = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--scrub") && hasValue) simSettings.turnEfficiency = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--csv") && hasValue) csv = argv[++i];
+        else {
+            fprintf(stderr,
+                    "usage: gainSweep [--lateral | --angular] [--steps n] [--rounds n] [--accuracy in/deg]\n"
+                    "                 [--threads n] [--time-constant s] [--scrub 0-1] [--csv file]\n");
+            return 1;
+        }
+    }
+    FILE* file = nullptr;
+    if (csv != nullptr) {
+        file = fopen(csv, "w");
+        if (file == nullptr) {
+            fprintf(stderr, "gainSweep: cannot write %s\n", csv);
+            return 1;
+        }
+        fprintf(file, "controller,kP,kI,kD,windupRange,smallError,smallErrorTimeout,largeError,largeErrorTimeout,"
+                      "settleTime,overshoot,finalError\n");
+    }
+
+    printf("%u threads, %d grid steps, %d refinement rounds\n", threads, steps, rounds);
+    if (lateral) {
+        const std::vector<Score> front = sweep(true, steps, rounds, accuracy, threads, simSettings);
+        if (file != nullptr) writeCsv(file, "lateral", front);
+    }
+    if (angular) {
+        const std::vector<Score> front = sweep(false, steps, rounds, accuracy, threads, simSettings);
+        if (file != nullptr) writeCsv(file, "angular", front);
+    }
+    if (file != nullptr) fclose(file);
+    return 0;
+}
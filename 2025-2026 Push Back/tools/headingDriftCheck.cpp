@@ -0,0 +1,135 @@
+/**
+ * @file headingDriftCheck.cpp
+ * @brief Host check of how far kachow::HeadingFusion's heading drifts over a skills run
+ *
+ * A 60 second skills run is simulated many times over: bursts of driving and turning between stops to score or wait
+ * on match loads. Each IMU reads the true turn plus a constant bias, a slowly wandering bias, white noise and a small
+ * scale error, all drawn at random for every run. The fused heading's error at the end of the run is compared with
+ * either IMU on its own, and the check fails if more than 5% of runs end with the fused heading off by more than
+ * --tolerance.
+ *
+ * Bias is what HeadingFusion learns while still, but the scale error can only be averaged between the two IMUs, so it
+ * is kept apart: with --scale 0 only the drift is left, which is what the fusion is meant to take out. The error sizes
+ * are assumed rather than measured off our IMUs; compare the one IMU column against what a single IMU really drifts.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/headingDriftCheck.cpp src/kachow/headingFusion.cpp -o bin/headingDriftCheck
+ * bin/headingDriftCheck
+ * bin/headingDriftCheck --scale 0 --tolerance 0.5
+ * bin/headingDriftCheck --runs 1000 --seed 7
+ * @endcode
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "kachow/headingFusion.hpp"
+
+namespace {
+constexpr float dt = 0.01;
+constexpr float runTime = 60;
+
+struct ImuErrors {
+        // deg/s
+        float bias;
+        // deg/s per √s the bias wanders by
+        float biasWalk;
+        // deg/s, per sample
+        float noise;
+        // fraction of every turn over or under read
+        float scale;
+};
+
+// draws how one IMU is off, for one run
+ImuErrors drawErrors(std::mt19937& rng, float scaleError) {
+    std::normal_distribution<float> normal(0, 1);
+    return {0.03f * normal(rng), 0.002f, 0.1f, scaleError * normal(rng)};
+}
+
+struct Result {
+        // end of run heading errors, in degrees
+        float first;
+        float second;
+        float fused;
+};
+
+Result simulate(std::mt19937& rng, float scaleError) {
+    std::normal_distribution<float> normal(0, 1);
+    std::uniform_real_distribution<float> uniform(0, 1);
+    ImuErrors errors[2] = {drawErrors(rng, scaleError), drawErrors(rng, scaleError)};
+    kachow::HeadingFusion fusion;
+    float truth = 0, alone[2] = {0, 0};
+
+    float time = 0;
+    while (time < runTime) {
+        // drive with a gentle curve, turn to the next target, then stop to score
+        const float turnRate = (uniform(rng) < 0.5 ? -1 : 1) * (120 + 200 * uniform(rng));
+        const struct {
+                float rate;
+                float duration;
+                bool still;
+        } phases[] = {{20 * (uniform(rng) - 0.5f), 0.8f + 1.5f * uniform(rng), false},
+                      {turnRate, 0.3f + 0.6f * uniform(rng), false},
+                      {0, 0.5f + 2.5f * uniform(rng), true}};
+        for (const auto& phase : phases) {
+            for (float t = 0; t < phase.duration && time < runTime; t += dt, time += dt) {
+                const float change = phase.rate * dt;
+                truth += change;
+                float read[2];
+                for (int i = 0; i < 2; i++) {
+                    errors[i].bias += errors[i].biasWalk * std::sqrt(dt) * normal(rng);
+                    read[i] = change * (1 + errors[i].scale) + (errors[i].bias + errors[i].noise * normal(rng)) * dt;
+                    alone[i] += read[i];
+                }
+                fusion.update({read[0], read[1], phase.still, dt});
+            }
+        }
+    }
+    return {std::fabs(alone[0] - truth), std::fabs(alone[1] - truth), std::fabs(fusion.getHeading() - truth)};
+}
+
+// value below which share of the errors fall
+float percentile(std::vector<float> errors, float share) {
+    std::sort(errors.begin(), errors.end());
+    return errors[std::min(size_t(share * errors.size()), errors.size() - 1)];
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int runs = 500;
+    unsigned seed = 1;
+    // assumed. Spinning the robot ten turns against a wall shows the real one
+    float scale = 0.001;
+    float tolerance = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) runs = std::max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) scale = atof(argv[++i]) / 100;
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--runs n] [--seed n] [--scale error in %%] [--tolerance degrees]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<float> single, fused;
+    for (int run = 0; run < runs; run++) {
+        const Result result = simulate(rng, scale);
+        single.push_back(result.first);
+        single.push_back(result.second);
+        fused.push_back(result.fused);
+    }
+
+    printf("%d runs of %.0fs, scale error %.2f%%\n", runs, runTime, scale * 100);
+    printf("              median   95th pct\n");
+    printf("one IMU      %6.2f°   %6.2f°\n", percentile(single, 0.5), percentile(single, 0.95));
+    printf("fused        %6.2f°   %6.2f°\n", percentile(fused, 0.5), percentile(fused, 0.95));
+    const bool ok = percentile(fused, 0.95) <= tolerance;
+    if (ok) printf("fused heading within %.2f° in 95%% of runs\n", tolerance);
+    else printf("DRIFT: fused heading past %.2f° in over 5%% of runs\n", tolerance);
+    return ok ? 0 : 1;
+}
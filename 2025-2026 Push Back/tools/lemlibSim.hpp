@@ -0,0 +1,298 @@
+/**
+ * @file lemlibSim.hpp
+ * @brief LemLib's motion algorithms for the host tools
+ *
+ * Re-implements what lemlib::Chassis does each 10ms iteration of moveToPoint, moveToPose and turnToHeading, along with
+ * the PID and exit conditions they use, so a tool can drive sim::DriveSim the way the robot drives itself. Follows
+ * LemLib 0.5; if LemLib is updated, check these still match. Header only, like driveSim.hpp.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+/** the fields of lemlib::ControllerSettings */
+struct ControllerSettings {
+        float kP, kI, kD;
+        float windupRange;
+        float smallError, smallErrorTimeout;
+        float largeError, largeErrorTimeout;
+        float slew;
+};
+
+/** lemlib::PID as the chassis builds it, with sign flip reset. The first update sees a previous error of 0 */
+class PID {
+    public:
+        explicit PID(const ControllerSettings& settings)
+            : kP(settings.kP),
+              kI(settings.kI),
+              kD(settings.kD),
+              windupRange(settings.windupRange) {}
+
+        float update(float error) {
+            integral += error;
+            if (std::signbit(error) != std::signbit(prevError)) integral = 0;
+            if (windupRange != 0 && std::fabs(error) > windupRange) integral = 0;
+            const float derivative = error - prevError;
+            prevError = error;
+            return error * kP + integral * kI + derivative * kD;
+        }
+    private:
+        float kP, kI, kD, windupRange;
+        float integral = 0;
+        float prevError = 0;
+};
+
+/** lemlib::ExitCondition, with time passed in rather than read from the clock */
+class ExitCondition {
+    public:
+        ExitCondition(float range, float time)
+            : range(range),
+              time(time) {}
+
+        bool update(float input, int now) {
+            if (std::fabs(input) > range) startTime = -1;
+            else if (startTime == -1) startTime = now;
+            else if (now >= startTime + time) done = true;
+            return done;
+        }
+
+        bool getExit() const { return done; }
+    private:
+        float range, time;
+        int startTime = -1;
+        bool done = false;
+};
+
+/** lemlib::slew */
+inline float slew(float target, float current, float maxChange) {
+    if (maxChange == 0) return target;
+    return current + std::clamp(target - current, -maxChange, maxChange);
+}
+
+/** lemlib::angleError in radians, target minus position wrapped to -pi to pi */
+inline float angleError(float target, float position) { return std::remainder(target - position, 2 * M_PI); }
+
+inline float sgn(float x) { return x < 0 ? -1 : 1; }
+
+/** pose in inches and standard position radians, like getPose(true, true) */
+struct Pose {
+        float x, y, theta;
+};
+
+enum class MotionType { POINT, POSE, TURN };
+
+/** the LemLib parameters the routines use, for all three motions */
+struct MotionParams {
+        bool forwards = true;
+        float maxSpeed = 127;
+        float minSpeed = 0;
+        float earlyExitRange = 0;
+        float lead = 0.6;
+        /** moveToPose's horizontalDrift. 0 uses the drivetrain's */
+        float horizontalDrift = 0;
+};
+
+/**
+ * @brief one moveToPoint, moveToPose or turnToHeading call, run one iteration at a time
+ *
+ * Call update every 10ms with the odometry pose until it returns false.
+ */
+class Motion {
+    public:
+        /**
+         * @param theta compass degrees, for POSE and TURN
+         * @param horizontalDrift the drivetrain's horizontal drift, 8 on this robot
+         */
+        Motion(MotionType type, float x, float y, float theta, int timeout, MotionParams params,
+               const ControllerSettings& lateral, const ControllerSettings& angular, float horizontalDrift = 8)
+            : type(type),
+              targetX(x),
+              targetY(y),
+              timeout(timeout),
+              params(params),
+              lateralSlew(lateral.slew),
+              angularSlew(angular.slew),
+              lateralPID(lateral),
+              angularPID(angular),
+              lateralSmallExit(lateral.smallError, lateral.smallErrorTimeout),
+              lateralLargeExit(lateral.largeError, lateral.largeErrorTimeout),
+              angularSmallExit(angular.smallError, angular.smallErrorTimeout),
+              angularLargeExit(angular.largeError, angular.largeErrorTimeout) {
+            if (type == MotionType::TURN) {
+                targetTheta = theta;
+            } else if (type == MotionType::POSE) {
+                targetTheta = M_PI_2 - theta * M_PI / 180;
+                if (!params.forwards) targetTheta = std::fmod(targetTheta + M_PI, 2 * M_PI);
+                if (this->params.horizontalDrift == 0) this->params.horizontalDrift = horizontalDrift;
+            }
+        }
+
+        /**
+         * @brief run one iteration
+         *
+         * @param pose where odometry says the robot is
+         * @param left set to the left motor command
+         * @param right set to the right motor command
+         * @return false once the motion has finished, in which case left and right are not set
+         */
+        bool update(const Pose& pose, float& left, float& right) {
+            const int now = elapsed;
+            elapsed += 10;
+            if (now >= timeout) return false;
+            if (type == MotionType::TURN) return turn(pose, now, left, right);
+            // lateral motions only end on the exit conditions once close
+            if (close && (lateralSmallExit.getExit() || lateralLargeExit.getExit())) return false;
+            return type == MotionType::POINT ? point(pose, now, left, right) : boomerang(pose, now, left, right);
+        }
+
+        /** ms since the motion started */
+        int getElapsed() const { return elapsed; }
+    private:
+        bool point(const Pose& pose, int now, float& left, float& right) {
+            const float toTarget = std::atan2(targetY - pose.y, targetX - pose.x);
+            if (now == 0) targetTheta = toTarget;
+            const float distance = std::hypot(targetX - pose.x, targetY - pose.y);
+            if (!close && distance < 7.5) {
+                close = true;
+                params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+            }
+
+            // motion chaining
+            const bool side = (pose.y - targetY) * -std::sin(targetTheta) <=
+                              (pose.x - targetX) * std::cos(targetTheta) + params.earlyExitRange;
+            if (prevSide == -1) prevSide = side;
+            if (side != prevSide && params.minSpeed != 0) return false;
+            prevSide = side;
+
+            const float robotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+            const float angularError = angleError(robotTheta, toTarget);
+            const float lateralError = distance * std::cos(angleError(pose.theta, toTarget));
+            lateralSmallExit.update(lateralError, now);
+            lateralLargeExit.update(lateralError, now);
+
+            float lateralOut = lateralPID.update(lateralError);
+            float angularOut = angularPID.update(angularError * 180 / M_PI);
+            if (close) angularOut = 0;
+            lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+            angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+            if (!close) lateralOut = slew(lateralOut, prevLateralOut, lateralSlew);
+            finish(lateralOut, angularOut, left, right);
+            return true;
+        }
+
+        bool boomerang(const Pose& pose, int now, float& left, float& right) {
+            const float distance = std::hypot(targetX - pose.x, targetY - pose.y);
+            if (!close && distance < 7.5) {
+                close = true;
+                params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+            }
+            // the carrot point leads the robot in along the target heading
+            float carrotX = targetX, carrotY = targetY;
+            if (!close) {
+                carrotX -= std::cos(targetTheta) * params.lead * distance;
+                carrotY -= std::sin(targetTheta) * params.lead * distance;
+            }
+
+            // motion chaining
+            const auto onSide = [&](float x, float y) {
+                return (y - targetY) * -std::sin(targetTheta) <=
+                       (x - targetX) * std::cos(targetTheta) + params.earlyExitRange;
+            };
+            const bool sameSide = onSide(pose.x, pose.y) == onSide(carrotX, carrotY);
+            if (!sameSide && prevSameSide && close && params.minSpeed != 0) return false;
+            prevSameSide = sameSide;
+
+            const float toCarrot = std::atan2(carrotY - pose.y, carrotX - pose.x);
+            const float robotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+            const float angularError = close ? angleError(robotTheta, targetTheta) : angleError(robotTheta, toCarrot);
+            const float carrotCos = std::cos(angleError(pose.theta, toCarrot));
+            float lateralError = std::hypot(carrotX - pose.x, carrotY - pose.y);
+            lateralError *= close ? carrotCos : sgn(carrotCos);
+            lateralSmallExit.update(lateralError, now);
+            lateralLargeExit.update(lateralError, now);
+
+            float lateralOut = lateralPID.update(lateralError);
+            float angularOut = angularPID.update(angularError * 180 / M_PI);
+            lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+            angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+            if (!close) lateralOut = slew(lateralOut, prevLateralOut, lateralSlew);
+
+            // slow down on tight arcs so the wheels do not slip
+            const float dx = carrotX - pose.x, dy = carrotY - pose.y;
+            const float offset = std::sin(pose.theta) * dx - std::cos(pose.theta) * dy;
+            const float curvature = 2 * std::fabs(offset) / (dx * dx + dy * dy);
+            if (curvature > 0) {
+                const float maxSlipSpeed = std::sqrt(params.horizontalDrift / curvature * 9.8f);
+                lateralOut = std::clamp(lateralOut, -maxSlipSpeed, maxSlipSpeed);
+            }
+            // turning takes priority over driving
+            const float overturn = std::fabs(angularOut) + std::fabs(lateralOut) - params.maxSpeed;
+            if (overturn > 0) lateralOut -= lateralOut > 0 ? overturn : -overturn;
+            finish(lateralOut, angularOut, left, right);
+            return true;
+        }
+
+        bool turn(const Pose& pose, int now, float& left, float& right) {
+            if (angularSmallExit.getExit() || angularLargeExit.getExit()) return false;
+            // compass degrees, clockwise positive
+            const float heading = 90 - pose.theta * 180 / M_PI;
+            const float deltaTheta = std::remainder(targetTheta - heading, 360.0f);
+            if (now == 0) prevDeltaTheta = deltaTheta;
+            // motion chaining
+            if (params.minSpeed != 0 && std::fabs(deltaTheta) < params.earlyExitRange) return false;
+            if (params.minSpeed != 0 && sgn(deltaTheta) != sgn(prevDeltaTheta)) return false;
+            prevDeltaTheta = deltaTheta;
+
+            float power = angularPID.update(deltaTheta);
+            angularSmallExit.update(deltaTheta, now);
+            angularLargeExit.update(deltaTheta, now);
+            power = std::clamp(power, -params.maxSpeed, params.maxSpeed);
+            power = slew(power, prevAngularOut, angularSlew);
+            if (deltaTheta > 0 && power < params.minSpeed) power = params.minSpeed;
+            if (deltaTheta < 0 && power > -params.minSpeed) power = -params.minSpeed;
+            prevAngularOut = power;
+            left = power;
+            right = -power;
+            return true;
+        }
+
+        // direction and minimum speed limits, then mix into motor commands
+        void finish(float lateralOut, float angularOut, float& left, float& right) {
+            if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+            else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+            if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0)
+                lateralOut = std::fabs(params.minSpeed);
+            if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0)
+                lateralOut = -std::fabs(params.minSpeed);
+            prevLateralOut = lateralOut;
+
+            left = lateralOut + angularOut;
+            right = lateralOut - angularOut;
+            const float ratio = std::fmax(std::fabs(left), std::fabs(right)) / params.maxSpeed;
+            if (ratio > 1) {
+                left /= ratio;
+                right /= ratio;
+            }
+        }
+
+        MotionType type;
+        float targetX, targetY;
+        /** compass degrees for TURN, standard radians otherwise */
+        float targetTheta = 0;
+        int timeout;
+        MotionParams params;
+        float lateralSlew, angularSlew;
+        PID lateralPID, angularPID;
+        ExitCondition lateralSmallExit, lateralLargeExit, angularSmallExit, angularLargeExit;
+        int elapsed = 0;
+        bool close = false;
+        int prevSide = -1;
+        bool prevSameSide = false;
+        float prevLateralOut = 0;
+        float prevAngularOut = 0;
+        float prevDeltaTheta = 0;
+};
+} // namespace sim
@@ -0,0 +1,94 @@
+/**
+ * @file pathgen.cpp
+ * @brief Host tool that converts LemLib text paths into binary path assets
+ *
+ * Reads the `x, y, speed` lines of a path.jerryio / LemLib text path up to `endData` and writes a .kpath file (see
+ * include/kachow/path.hpp) with heading, curvature and cumulative distance worked out for every point.
+ *
+ * The build runs this automatically for every .txt path in static/ (firmware/path-asset.mk). To run it by hand:
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/pathgen.cpp -o bin/pathgen
+ * bin/pathgen static/example.txt static/example.kpath
+ * @endcode
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "kachow/path.hpp"
+
+using kachow::PathPoint;
+
+namespace {
+std::vector<PathPoint> readTextPath(FILE* file) {
+    std::vector<PathPoint> points;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (strncmp(line, "endData", 7) == 0) break;
+        PathPoint point {};
+        if (sscanf(line, "%f , %f , %f", &point.x, &point.y, &point.velocity) == 3) points.push_back(point);
+    }
+    return points;
+}
+
+// signed curvature of the circle through three points, positive when turning left
+float curvature(const PathPoint& a, const PathPoint& b, const PathPoint& c) {
+    const float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    const float ab = std::hypot(b.x - a.x, b.y - a.y);
+    const float bc = std::hypot(c.x - b.x, c.y - b.y);
+    const float ca = std::hypot(a.x - c.x, a.y - c.y);
+    if (ab * bc * ca == 0) return 0;
+    return 2 * cross / (ab * bc * ca);
+}
+
+void fillDerived(std::vector<PathPoint>& points) {
+    const size_t n = points.size();
+    for (size_t i = 0; i < n; i++) {
+        // heading from the neighbouring points, one sided at the ends
+        const PathPoint& before = points[i == 0 ? 0 : i - 1];
+        const PathPoint& after = points[i + 1 == n ? i : i + 1];
+        points[i].heading = std::atan2(after.y - before.y, after.x - before.x);
+        points[i].curvature = i == 0 || i + 1 == n ? 0 : curvature(before, points[i], after);
+        points[i].distance =
+            i == 0 ? 0 : points[i - 1].distance + std::hypot(points[i].x - before.x, points[i].y - before.y);
+    }
+    // the ends have no neighbours on one side, use the next point in
+    if (n > 2) {
+        points[0].curvature = points[1].curvature;
+        points[n - 1].curvature = points[n - 2].curvature;
+    }
+    // the follower stops at the only point with no speed
+    if (n > 0) points[n - 1].velocity = 0;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <path.txt> <path.kpath>\n", argv[0]);
+        return 1;
+    }
+    FILE* in = fopen(argv[1], "r");
+    if (in == nullptr) {
+        fprintf(stderr, "pathgen: cannot open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<PathPoint> points = readTextPath(in);
+    fclose(in);
+    if (points.size() < 2 || points.size() > UINT16_MAX) {
+        fprintf(stderr, "pathgen: %s has %zu points, expected 2 to %d\n", argv[1], points.size(), UINT16_MAX);
+        return 1;
+    }
+    fillDerived(points);
+
+    kachow::PathHeader header {kachow::PATH_MAGIC, kachow::PATH_VERSION, uint16_t(points.size()),
+                               points.back().distance, 0};
+    FILE* out = fopen(argv[2], "wb");
+    if (out == nullptr) {
+        fprintf(stderr, "pathgen: cannot write %s\n", argv[2]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(points.data(), sizeof(PathPoint), points.size(), out);
+    fclose(out);
+    return 0;
+}
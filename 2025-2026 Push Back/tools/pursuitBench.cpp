@@ -0,0 +1,80 @@
+/**
+ * @file pursuitBench.cpp
+ * @brief Host benchmark for kachow::PurePursuit on long paths
+ *
+ * Builds synthetic paths from 100 to 10,000 points, drives a simulated robot along each one with the pure pursuit
+ * controller and reports how long update() takes per iteration. With the windowed search the time per iteration should
+ * stay flat as the path gets longer.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/pursuitBench.cpp src/kachow/purePursuit.cpp src/kachow/path.cpp \
+ *     src/kachow/splinePath.cpp src/kachow/spline.cpp -o bin/pursuitBench
+ * bin/pursuitBench
+ * @endcode
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "kachow/path.hpp"
+#include "kachow/purePursuit.hpp"
+
+using kachow::PathPoint;
+
+namespace {
+// a gentle S curve, points 0.5in apart, in the same layout pathgen writes
+std::vector<uint8_t> makePath(size_t count) {
+    std::vector<PathPoint> points(count);
+    for (size_t i = 0; i < count; i++) {
+        PathPoint& point = points[i];
+        const float s = i * 0.5f;
+        point.x = 12 * std::sin(s / 24);
+        point.y = s;
+        point.velocity = i + 1 == count ? 0 : 100;
+        point.distance = i == 0 ? 0 : points[i - 1].distance + std::hypot(point.x - points[i - 1].x, 0.5f);
+    }
+    const kachow::PathHeader header {kachow::PATH_MAGIC, kachow::PATH_VERSION, uint16_t(count), points.back().distance,
+                                     0};
+    std::vector<uint8_t> buffer(sizeof(header) + count * sizeof(PathPoint));
+    memcpy(buffer.data(), &header, sizeof(header));
+    memcpy(buffer.data() + sizeof(header), points.data(), count * sizeof(PathPoint));
+    return buffer;
+}
+} // namespace
+
+int main() {
+    constexpr float trackWidth = 11.375;
+    // 127 is about 61 in/s with 3.25" wheels at 450rpm, one iteration is 10ms
+    constexpr float inchesPerTick = 61.0f / 127 * 0.01f;
+
+    printf("%8s %10s %10s %12s %12s\n", "points", "length", "iters", "ns/update", "end error");
+    for (size_t count : {100, 300, 1000, 3000, 10000}) {
+        const std::vector<uint8_t> buffer = makePath(count);
+        const kachow::PathView path(buffer.data(), buffer.size());
+        kachow::PurePursuit pursuit(path, 10);
+
+        float x = 0, y = 0, theta = M_PI / 2;
+        size_t iterations = 0;
+        std::chrono::nanoseconds elapsed {0};
+        while (iterations < 1000000) {
+            const auto start = std::chrono::steady_clock::now();
+            const kachow::PursuitCommand command = pursuit.update(x, y, theta);
+            elapsed += std::chrono::steady_clock::now() - start;
+            iterations++;
+            if (command.done) break;
+
+            // unicycle step with the same wheel speeds Chassis::follow would send
+            const float left = command.velocity * (2 - command.curvature * trackWidth) / 2 * inchesPerTick;
+            const float right = command.velocity * (2 + command.curvature * trackWidth) / 2 * inchesPerTick;
+            const float forward = (left + right) / 2;
+            theta += (right - left) / trackWidth;
+            x += forward * std::cos(theta);
+            y += forward * std::sin(theta);
+        }
+        const PathPoint last = path[path.size() - 1];
+        printf("%8zu %10.1f %10zu %12.1f %12.2f\n", count, path.length(), iterations,
+               double(elapsed.count()) / iterations, std::hypot(last.x - x, last.y - y));
+    }
+    return 0;
+}
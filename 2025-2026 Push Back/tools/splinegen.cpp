@@ -0,0 +1,300 @@
+/**
+ * @file splinegen.cpp
+ * @brief Host tool that turns waypoints into a smooth path with a time-optimal velocity profile
+ *
+ * Reads a waypoint file, fits a quintic Hermite spline (or cubic Bézier with --bezier) through the waypoints, samples it
+ * every --spacing inches and works out the fastest speed at every point that stays within the limits:
+ * - neither wheel faster than the drivetrain's top speed, 450rpm on 3.25" wheels, which limits speed in turns
+ * - --lateral in/s² of sideways acceleration in turns, if set
+ * - --accel in/s² speeding up and slowing down, starting and ending at rest
+ *
+ * The result is written as a LemLib text path (`x, y, speed` lines with speed from 0 to 127, then `endData`), so it can
+ * go straight into static/ and be used with ASSET() by either lemlib::Chassis::follow or kachow::Chassis::follow, which
+ * gets its binary version from the build. If the output file ends in .kspl the spline segments themselves are written
+ * instead, as a spline path asset (include/kachow/splinePath.hpp) that is a fraction of the size.
+ *
+ * Waypoint files have one `x, y` or `x, y, heading` line per waypoint, in inches and degrees with the same heading
+ * convention as chassis.moveToPose (0 is +y, clockwise is positive). Waypoints without a heading point towards the
+ * waypoints either side of them. Lines starting with # are ignored. Keep waypoint files out of static/, everything in
+ * there is linked into the program.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/splinegen.cpp src/kachow/spline.cpp -o bin/splinegen
+ * bin/splinegen --accel 120 paths/rushMiddle.wp static/rushMiddle.txt
+ * bin/splinegen --accel 120 paths/rushMiddle.wp static/rushMiddle.kspl
+ * @endcode
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "kachow/splinePath.hpp"
+
+using kachow::SplineSegment;
+
+namespace {
+struct Waypoint {
+        float x;
+        float y;
+        /** radians, standard position. NAN if the waypoint has no heading */
+        float heading;
+};
+
+struct Sample {
+        float x;
+        float y;
+        float curvature;
+        float distance;
+        /** in/s */
+        float velocity;
+};
+
+struct Settings {
+        bool bezier = false;
+        float spacing = 1;
+        float trackWidth = 11.375;
+        /** 450rpm on 3.25" wheels */
+        float maxSpeed = 450.0f / 60 * M_PI * 3.25f;
+        float accel = 100;
+        float lateral = 0;
+        /** LemLib and kachow::PurePursuit both stop at the first point with no speed, so only the last one may be 0 */
+        float minSpeed = 8;
+};
+
+std::vector<Waypoint> readWaypoints(FILE* file) {
+    std::vector<Waypoint> waypoints;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (line[0] == '#') continue;
+        float x, y, heading;
+        const int fields = sscanf(line, "%f , %f , %f", &x, &y, &heading);
+        if (fields < 2) continue;
+        // compass degrees to standard position radians
+        waypoints.push_back({x, y, fields == 3 ? float(M_PI / 2 - heading * M_PI / 180) : NAN});
+    }
+    return waypoints;
+}
+
+// fill in missing headings from the neighbouring waypoints, one sided at the ends
+void fillHeadings(std::vector<Waypoint>& waypoints) {
+    const size_t n = waypoints.size();
+    for (size_t i = 0; i < n; i++) {
+        if (!std::isnan(waypoints[i].heading)) continue;
+        const Waypoint& before = waypoints[i == 0 ? 0 : i - 1];
+        const Waypoint& after = waypoints[i + 1 == n ? i : i + 1];
+        waypoints[i].heading = std::atan2(after.y - before.y, after.x - before.x);
+    }
+}
+
+std::vector<SplineSegment> fitSegments(const std::vector<Waypoint>& waypoints, bool bezier) {
+    std::vector<SplineSegment> segments;
+    for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+        const Waypoint& a = waypoints[i];
+        const Waypoint& b = waypoints[i + 1];
+        const float chord = std::hypot(b.x - a.x, b.y - a.y);
+        if (bezier) {
+            // control points a third of the way along the chord, in the direction of travel
+            const float d = chord / 3;
+            segments.push_back(SplineSegment::bezier(a.x, a.y, a.x + d * std::cos(a.heading),
+                                                     a.y + d * std::sin(a.heading), b.x - d * std::cos(b.heading),
+                                                     b.y - d * std::sin(b.heading), b.x, b.y));
+        } else {
+            // tangents a bit longer than the chord and no curvature at the waypoints keep the segments from bulging
+            // while still joining with continuous curvature
+            const float d = 1.2f * chord;
+            segments.push_back(SplineSegment::hermite({a.x, a.y, d * std::cos(a.heading), d * std::sin(a.heading)},
+                                                      {b.x, b.y, d * std::cos(b.heading), d * std::sin(b.heading)}));
+        }
+    }
+    return segments;
+}
+
+// samples every `spacing` inches of arc length, found by stepping each segment finely. segmentStart gets the distance
+// to the start of every segment, then the total length
+std::vector<Sample> sample(const std::vector<SplineSegment>& segments, float spacing,
+                           std::vector<float>& segmentStart) {
+    constexpr int steps = 1000;
+    std::vector<Sample> samples;
+    float distance = 0;
+    float nextSample = 0;
+    float lastX, lastY;
+    segments.front().position(0, lastX, lastY);
+    for (const SplineSegment& segment : segments) {
+        segmentStart.push_back(distance);
+        for (int i = 0; i <= steps; i++) {
+            const float t = float(i) / steps;
+            float x, y;
+            segment.position(t, x, y);
+            distance += std::hypot(x - lastX, y - lastY);
+            lastX = x;
+            lastY = y;
+            if (distance >= nextSample) {
+                samples.push_back({x, y, segment.curvature(t), distance, 0});
+                nextSample = distance + spacing;
+            }
+        }
+    }
+    segmentStart.push_back(distance);
+    // always end exactly on the last waypoint
+    if (samples.back().distance < distance) samples.push_back({lastX, lastY, 0, distance, 0});
+    return samples;
+}
+
+void profile(std::vector<Sample>& samples, const Settings& settings) {
+    for (Sample& sample : samples) {
+        const float curvature = std::fabs(sample.curvature);
+        // the outside wheel goes (1 + curvature * trackWidth / 2) times faster than the middle of the robot
+        sample.velocity = settings.maxSpeed / (1 + curvature * settings.trackWidth / 2);
+        if (settings.lateral > 0 && curvature > 0) {
+            sample.velocity = std::min(sample.velocity, std::sqrt(settings.lateral / curvature));
+        }
+    }
+    // v² = u² + 2as, forwards from rest then backwards to rest
+    samples.front().velocity = 0;
+    samples.back().velocity = 0;
+    for (size_t i = 1; i < samples.size(); i++) {
+        const float ds = samples[i].distance - samples[i - 1].distance;
+        const float reachable = std::sqrt(samples[i - 1].velocity * samples[i - 1].velocity + 2 * settings.accel * ds);
+        samples[i].velocity = std::min(samples[i].velocity, reachable);
+    }
+    for (size_t i = samples.size() - 1; i-- > 0;) {
+        const float ds = samples[i + 1].distance - samples[i].distance;
+        const float reachable = std::sqrt(samples[i + 1].velocity * samples[i + 1].velocity + 2 * settings.accel * ds);
+        samples[i].velocity = std::min(samples[i].velocity, reachable);
+    }
+}
+
+// profile speed a distance along the path, 0-127
+float speedAt(const std::vector<Sample>& samples, float distance, const Settings& settings) {
+    const auto after = std::lower_bound(samples.begin(), samples.end(), distance,
+                                        [](const Sample& sample, float d) { return sample.distance < d; });
+    float velocity;
+    if (after == samples.begin()) velocity = samples.front().velocity;
+    else if (after == samples.end()) velocity = samples.back().velocity;
+    else {
+        const Sample& before = *(after - 1);
+        const float span = after->distance - before.distance;
+        velocity = span > 0 ? before.velocity + (after->velocity - before.velocity) *
+                                                     (distance - before.distance) / span
+                            : before.velocity;
+    }
+    return std::min(std::max(velocity, settings.minSpeed) / settings.maxSpeed * 127, 127.0f);
+}
+
+bool writeTextPath(FILE* out, const std::vector<Sample>& samples, const Settings& settings) {
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample& sample = samples[i];
+        const float velocity = i + 1 == samples.size() ? 0 : std::max(sample.velocity, settings.minSpeed);
+        fprintf(out, "%.3f, %.3f, %.3f\n", sample.x, sample.y, std::min(velocity / settings.maxSpeed * 127, 127.0f));
+    }
+    return fprintf(out, "endData\n") > 0;
+}
+
+// the spline path follower stops within half an inch of the end, so unlike the text path no speed is 0
+bool writeSplinePath(FILE* out, const std::vector<SplineSegment>& segments, const std::vector<float>& segmentStart,
+                     const std::vector<Sample>& samples, const Settings& settings) {
+    const kachow::PathHeader header {kachow::SPLINE_PATH_MAGIC, kachow::SPLINE_PATH_VERSION, uint16_t(segments.size()),
+                                     segmentStart.back(), 0};
+    if (fwrite(&header, sizeof(header), 1, out) != 1) return false;
+    for (size_t i = 0; i < segments.size(); i++) {
+        kachow::SplineRecord record {segments[i], {}};
+        for (size_t j = 0; j < kachow::SPLINE_VELOCITY_SAMPLES; j++) {
+            const float fraction = float(j) / (kachow::SPLINE_VELOCITY_SAMPLES - 1);
+            const float distance = segmentStart[i] + (segmentStart[i + 1] - segmentStart[i]) * fraction;
+            record.velocity[j] = speedAt(samples, distance, settings);
+        }
+        if (fwrite(&record, sizeof(record), 1, out) != 1) return false;
+    }
+    return true;
+}
+
+float travelTime(const std::vector<Sample>& samples) {
+    float time = 0;
+    for (size_t i = 1; i < samples.size(); i++) {
+        const float average = (samples[i].velocity + samples[i - 1].velocity) / 2;
+        if (average > 0) time += (samples[i].distance - samples[i - 1].distance) / average;
+    }
+    return time;
+}
+
+void usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [--bezier] [--spacing in] [--track-width in] [--accel in/s^2] [--lateral in/s^2]"
+            " [--min-speed in/s] <waypoints> <path.txt>\n",
+            name);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    Settings settings;
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        const char* option = argv[arg];
+        if (strcmp(option, "--bezier") == 0) {
+            settings.bezier = true;
+            continue;
+        }
+        if (arg + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const float value = strtof(argv[++arg], nullptr);
+        if (strcmp(option, "--spacing") == 0) settings.spacing = value;
+        else if (strcmp(option, "--track-width") == 0) settings.trackWidth = value;
+        else if (strcmp(option, "--accel") == 0) settings.accel = value;
+        else if (strcmp(option, "--lateral") == 0) settings.lateral = value;
+        else if (strcmp(option, "--min-speed") == 0) settings.minSpeed = value;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - arg != 2 || settings.spacing <= 0 || settings.accel <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[arg], "r");
+    if (in == nullptr) {
+        fprintf(stderr, "splinegen: cannot open %s\n", argv[arg]);
+        return 1;
+    }
+    std::vector<Waypoint> waypoints = readWaypoints(in);
+    fclose(in);
+    if (waypoints.size() < 2) {
+        fprintf(stderr, "splinegen: %s has %zu waypoints, expected at least 2\n", argv[arg], waypoints.size());
+        return 1;
+    }
+    if (waypoints.size() > UINT16_MAX) {
+        fprintf(stderr, "splinegen: %s has %zu waypoints, the asset format holds at most %d\n", argv[arg],
+                waypoints.size(), UINT16_MAX);
+        return 1;
+    }
+    fillHeadings(waypoints);
+
+    const std::vector<SplineSegment> segments = fitSegments(waypoints, settings.bezier);
+    std::vector<float> segmentStart;
+    std::vector<Sample> samples = sample(segments, settings.spacing, segmentStart);
+    profile(samples, settings);
+
+    const char* outPath = argv[arg + 1];
+    const size_t outLength = strlen(outPath);
+    const bool spline = outLength > 5 && strcmp(outPath + outLength - 5, ".kspl") == 0;
+    FILE* out = fopen(outPath, spline ? "wb" : "w");
+    if (out == nullptr) {
+        fprintf(stderr, "splinegen: cannot write %s\n", outPath);
+        return 1;
+    }
+    const bool written = spline ? writeSplinePath(out, segments, segmentStart, samples, settings)
+                                : writeTextPath(out, samples, settings);
+    if (fclose(out) != 0 || !written) {
+        fprintf(stderr, "splinegen: failed writing %s\n", outPath);
+        return 1;
+    }
+
+    printf("%zu points, %.1f in, %.2f s at full speed\n", samples.size(), samples.back().distance,
+           travelTime(samples));
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file trackingWheelCheck.cpp
+ * @brief Host check that the horizontal tracking wheel is read and calibrated the way LemLib counts it
+ *
+ * While the horizontal tracking wheel is unplugged, GuardedRotation reads spinTicksPerDegree times the IMU's rotation
+ * instead. Here the robot spins in place, speeding up and slowing down, and that reading is turned into inches the way
+ * lemlib::TrackingWheel does and fed through LemLib 0.5's odometry update, ported below. A pure spin must leave the
+ * tracking center where it started, so the check fails if the pose strays from it by more than --tolerance at any
+ * point. Each case also prints the drift with the sign flipped, to show what a wheel read the wrong way round does.
+ *
+ * Then GeometrySolver is given the spins and slides a robot with a known tracking wheel would measure, taken with the
+ * wrong geometry, and has to find the wheel's real diameter and offset. A slide to the right has to be turned down
+ * rather than give a negative diameter.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/trackingWheelCheck.cpp src/kachow/geometryCalibration.cpp \
+ *     src/kachow/config.cpp -o bin/trackingWheelCheck
+ * bin/trackingWheelCheck
+ * bin/trackingWheelCheck --tolerance 0.001
+ * @endcode
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "kachow/geometryCalibration.hpp"
+
+namespace {
+struct Pose {
+        float x = 0;
+        float y = 0;
+        // radians, clockwise positive
+        float theta = 0;
+};
+
+// lemlib::update with a single horizontal wheel, and the drive standing in for the vertical one
+void odomUpdate(Pose& pose, float deltaY, float deltaX, float heading, float horizontalOffset) {
+    const float deltaHeading = heading - pose.theta;
+    const float avgHeading = pose.theta + deltaHeading / 2;
+    float localX = deltaX;
+    float localY = deltaY;
+    if (deltaHeading != 0) {
+        localX = 2 * std::sin(deltaHeading / 2) * (deltaX / deltaHeading + horizontalOffset);
+        localY = 2 * std::sin(deltaHeading / 2) * (deltaY / deltaHeading);
+    }
+    pose.x += localY * std::sin(avgHeading);
+    pose.y += localY * std::cos(avgHeading);
+    pose.x += localX * -std::cos(avgHeading);
+    pose.y += localX * std::sin(avgHeading);
+    pose.theta = heading;
+}
+
+// furthest the tracking center gets from where it started, in inches
+float spinDrift(float diameter, float offset, float turns, float ticksPerDegree) {
+    Pose pose;
+    float previous = 0;
+    float worst = 0;
+    const float duration = std::fabs(turns) * 2;
+    for (float t = 0.01; t <= duration + 1e-4; t += 0.01) {
+        // eases in and out, so the turn rate sweeps from nothing to its fastest and back
+        const float rotation = turns * 360 * (t / duration - std::sin(2 * M_PI * t / duration) / (2 * M_PI));
+        // GuardedRotation::fallbackPosition and lemlib::TrackingWheel::getDistanceTraveled
+        const long ticks = std::lround(rotation * ticksPerDegree);
+        const float distance = ticks * M_PI * diameter / 36000;
+        // the drive wheels roll equal and opposite in a spin, so the drive reads no forward motion
+        odomUpdate(pose, 0, distance - previous, rotation * M_PI / 180, offset);
+        previous = distance;
+        worst = std::max(worst, std::hypot(pose.x, pose.y));
+    }
+    return worst;
+}
+
+// whether the solver finds the wheel from runs measured as if it were a 2.1in wheel in the middle
+bool solverRecovers(float diameter, float offset) {
+    const kachow::OdometryGeometry measuredWith {11, 3.25, 2.1, 0};
+    // what the encoder says, when it is really a diameter wheel
+    const float scale = measuredWith.trackingDiameter / diameter;
+    kachow::GeometrySolver solver(measuredWith);
+    for (const float rotation : {3 * 2 * M_PI, -3 * 2 * M_PI}) {
+        const float drive = measuredWith.trackWidth / 2 * rotation;
+        solver.addSpin({drive, -drive, kachow::spinRoll(offset, rotation) * scale, rotation});
+    }
+    solver.addSlide(20 * scale, 20);
+    const kachow::OdometryGeometry solved = solver.solve();
+    const bool found =
+        std::fabs(solved.trackingDiameter - diameter) < 1e-3 && std::fabs(solved.trackingOffset - offset) < 1e-3;
+
+    // slid right, so it reads backwards
+    kachow::GeometrySolver wrongWay(measuredWith);
+    wrongWay.addSlide(-20 * scale, 20);
+    const bool rejected =
+        wrongWay.isSlideBackwards() && wrongWay.solve().trackingDiameter == measuredWith.trackingDiameter;
+    printf("diameter %4.2f  offset %5.2f  solved %.4f at %.4f  right slide %s\n", diameter, offset,
+           solved.trackingDiameter, solved.trackingOffset, rejected ? "turned down" : "ACCEPTED");
+    return found && rejected;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    float tolerance = 0.01;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--tolerance inches]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    struct Case {
+            float diameter;
+            float offset;
+            float turns;
+    };
+
+    const Case cases[] = {
+        {2, -1.5, 3}, // main.cpp's wheel
+        {2, -1.5, -3},
+        {2.75, 1.5, 5},
+        {2.75, 1.5, -5},
+        {3.25, -4, 1},
+        {2, 0, 2},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        const float ticksPerDegree = kachow::spinTicksPerDegree(c.diameter, c.offset);
+        const float drift = spinDrift(c.diameter, c.offset, c.turns, ticksPerDegree);
+        const float flipped = spinDrift(c.diameter, c.offset, c.turns, -ticksPerDegree);
+        printf("diameter %4.2f  offset %5.2f  turns %5.1f  drift %.5fin  (sign flipped %.2fin)\n", c.diameter,
+               c.offset, c.turns, drift, flipped);
+        ok = ok && drift <= tolerance;
+    }
+
+    printf(ok ? "the fallback holds still\n" : "DRIFT\n");
+
+    bool solved = true;
+    for (const Case& c : cases) solved = solverRecovers(c.diameter, c.offset) && solved;
+    printf(solved ? "the solver finds every wheel\n" : "SOLVER MISMATCH\n");
+    return ok && solved ? 0 : 1;
+}
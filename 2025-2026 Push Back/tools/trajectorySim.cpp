@@ -0,0 +1,125 @@
+/**
+ * @file trajectorySim.cpp
+ * @brief Host check of kachow::Ramsete against the drivetrain simulation
+ *
+ * Follows a trajectory the same way Chassis::followTrajectory does, once from exactly the right start pose and once
+ * from a start that is off by a few inches and degrees. For each run it prints how far the robot was from where the
+ * trajectory said it should be, and where it ended up. With no argument a test S curve is used; otherwise the argument
+ * is a .kspl written by splinegen. Trajectories are timed at 80% of top speed to leave the controller room to correct.
+ * Both followers lead their speeds by the simulated drive's time constant, as followTrajectory does with
+ * setTimeConstant.
+ *
+ * The check fails unless both RAMSETE runs end within TRAJECTORY_END_TOLERANCE of the end of the trajectory.
+ *
+ * @code
+ * g++ -std=c++20 -O2 -Iinclude tools/trajectorySim.cpp src/kachow/trajectory.cpp src/kachow/splinePath.cpp \
+ *     src/kachow/spline.cpp src/kachow/path.cpp -o bin/trajectorySim
+ * bin/trajectorySim
+ * bin/trajectorySim static/rushMiddle.kspl
+ * @endcode
+ */
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "driveSim.hpp"
+#include "kachow/trajectory.hpp"
+
+namespace {
+constexpr float dt = 0.01;
+
+struct Result {
+        float maxError;
+        float finalError;
+        float finalHeadingError;
+};
+
+Result run(const kachow::Trajectory& trajectory, const kachow::Ramsete* controller, float dx, float dy, float dTheta) {
+    sim::DriveSim robot;
+    const kachow::TrajectoryState first = trajectory.sample(0);
+    robot.setPose(first.x + dx, first.y + dy, first.theta + dTheta);
+    const float trackWidth = robot.settings.trackWidth;
+    const float maxSpeed = robot.settings.maxSpeed;
+    const float lead = robot.settings.timeConstant;
+
+    Result result {0, 0, 0};
+    const kachow::TrajectoryState last = trajectory.sample(trajectory.duration());
+    // same end condition as Chassis::followTrajectory, then let the robot coast to a stop
+    float t = 0;
+    for (; t < trajectory.duration() + kachow::TRAJECTORY_SETTLE_TIME; t += dt) {
+        const kachow::TrajectoryState goal = trajectory.sample(t);
+        const float error = std::hypot(goal.x - robot.x, goal.y - robot.y);
+        const float speed = std::fabs(robot.leftVel + robot.rightVel) / 2;
+        if (t >= trajectory.duration() && (controller == nullptr || (error < kachow::TRAJECTORY_END_TOLERANCE &&
+                                                                     speed < kachow::TRAJECTORY_END_SPEED))) {
+            break;
+        }
+        result.maxError = std::fmax(result.maxError, error);
+        const kachow::TrajectoryState reference = trajectory.sample(t, lead);
+        kachow::TrackerOutput output {reference.velocity, reference.angularVelocity};
+        if (controller != nullptr) output = controller->calculate(robot.x, robot.y, robot.theta, reference);
+        float left = (output.velocity - output.angularVelocity * trackWidth / 2) / maxSpeed * 127;
+        float right = (output.velocity + output.angularVelocity * trackWidth / 2) / maxSpeed * 127;
+        const float ratio = std::fmax(std::fabs(left), std::fabs(right)) / 127;
+        if (ratio > 1) {
+            left /= ratio;
+            right /= ratio;
+        }
+        robot.step(left, right, dt);
+    }
+    for (int i = 0; i < 50; i++) robot.step(0, 0, dt);
+    result.finalError = std::hypot(last.x - robot.x, last.y - robot.y);
+    result.finalHeadingError = std::fabs(std::remainder(last.theta - robot.theta, 2 * M_PI)) * 180 / M_PI;
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    kachow::Trajectory trajectory;
+    std::vector<uint8_t> buffer;
+    if (argc > 1) {
+        FILE* file = fopen(argv[1], "rb");
+        if (file == nullptr) {
+            fprintf(stderr, "trajectorySim: cannot open %s\n", argv[1]);
+            return 1;
+        }
+        uint8_t chunk[4096];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) buffer.insert(buffer.end(), chunk, chunk + read);
+        fclose(file);
+        const kachow::SplinePath path(buffer.data(), buffer.size());
+        if (!path.isValid()) {
+            fprintf(stderr, "trajectorySim: %s is not a spline path\n", argv[1]);
+            return 1;
+        }
+        trajectory = kachow::Trajectory::fromPath(path, 0.8f * sim::DriveSimSettings().maxSpeed);
+    } else {
+        // S curve: up the field, across, and up again
+        trajectory = kachow::Trajectory::generate({kachow::SplineSegment::hermite({0, 0, 0, 50}, {24, 36, 0, 50}),
+                                                   kachow::SplineSegment::hermite({24, 36, 0, 50}, {24, 72, 0, 50})},
+                                                  {0.8f * sim::DriveSimSettings().maxSpeed, 100, 11.375});
+    }
+    printf("trajectory: %zu states, %.2f s\n", trajectory.getStates().size(), trajectory.duration());
+
+    const kachow::Ramsete ramsete;
+    printf("%-28s %10s %10s %12s\n", "run", "max err", "final err", "final head");
+    const struct {
+            const char* name;
+            const kachow::Ramsete* controller;
+            float dx, dy, dTheta;
+    } runs[] = {
+        {"feedforward, exact start", nullptr, 0, 0, 0},
+        {"ramsete, exact start", &ramsete, 0, 0, 0},
+        {"feedforward, 3in 10deg off", nullptr, 3, -2, 0.17},
+        {"ramsete, 3in 10deg off", &ramsete, 3, -2, 0.17},
+    };
+    bool ok = true;
+    for (const auto& r : runs) {
+        const Result result = run(trajectory, r.controller, r.dx, r.dy, r.dTheta);
+        printf("%-28s %8.2fin %8.2fin %10.1fdeg\n", r.name, result.maxError, result.finalError,
+               result.finalHeadingError);
+        if (r.controller != nullptr) ok = ok && result.finalError < kachow::TRAJECTORY_END_TOLERANCE;
+    }
+    if (ok) printf("ramsete ends within %.1fin of the end\n", kachow::TRAJECTORY_END_TOLERANCE);
+    else printf("SHORT: ramsete ends more than %.1fin from the end\n", kachow::TRAJECTORY_END_TOLERANCE);
+    return ok ? 0 : 1;
+}